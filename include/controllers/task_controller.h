@@ -5,41 +5,81 @@
 #include <functional>
 #include <map>
 #include <set>
+#include <mutex>
 #include "../models/task.h"
 #include "../models/template.h"
 #include "../models/reminder.h"
+#include "../models/id_index.h"
+#include "../models/task_store.h"
+#include "../models/search_index.h"
+#include "../services/journal_service.h"
+#include "../services/snapshot_writer.h"
+#include "../services/search_service.h"
+#include "../services/task_query.h"
 
 class TaskController {
 private:
-    std::vector<Task> tasks;
+    TaskStore tasks;
+    // Строится при первом поиске, после этого обновляется вместе с задачами.
+    mutable SearchIndex searchIndex;
     std::vector<Reminder> reminders;
     std::map<std::string, TaskTemplate> templates;
     std::set<std::string> projectGroups;
     int nextId;
     bool modified;
     std::string dataFilePath;
+    std::string segmentDirectory;
+    JournalService journal;
+    int64_t snapshotSequence;
+    bool replayingJournal;
+
+    // Ключ сегмента -> номер файла, на который ссылается последний отправленный манифест,
+    // и ключ измененного сегмента -> номер контрольной точки, во время которой он изменен.
+    // Сегмент остается грязным, пока не будет записана более поздняя контрольная точка.
+    std::map<int32_t, int64_t> segmentFiles;
+    std::map<int32_t, int64_t> dirtySegments;
+    int64_t checkpointGeneration;
+    std::mutex dirtyMutex;
+
+    SnapshotWriter snapshotWriter;
+
+    static constexpr size_t CHECKPOINT_INTERVAL = 1000;
+    static constexpr int SEGMENT_SIZE = 4096;
+
+    void markSegmentDirty(int32_t key);
+    void markTaskDirty(int taskId);
+    void markRemindersDirty();
+    void markTemplateDirty(const std::string& name);
+    void markAllDirty();
+
+    void journalRecord(nlohmann::json record);
+    void journalTask(const Task& task);
+    void applyJournalRecord(const nlohmann::json& record);
+    void replayJournal();
 
 public:
     TaskController(const std::string& dataFile = "tasks.json");
     ~TaskController();
 
     int addTask(Task task);
-    bool editTask(int taskId, const Task& updatedTask);
+    bool editTask(int taskId, Task updatedTask);
+    // Меняет только поля из mask (TaskFields), значения переносятся из values.
+    bool patchTask(int taskId, unsigned mask, Task values);
     bool deleteTask(int taskId);
     bool markTaskComplete(int taskId, bool completed = true);
 
-    int addSubtask(int parentId, const Task& subtask);
-    bool editSubtask(int subtaskId, const Task& updatedSubtask);
+    int addSubtask(int parentId, Task subtask);
+    bool editSubtask(int subtaskId, Task updatedSubtask);
     bool deleteSubtask(int subtaskId);
     bool markSubtaskComplete(int subtaskId, bool completed = true);
 
-    void addTemplate(const TaskTemplate& templ);
-    bool updateTemplate(const std::string& name, const TaskTemplate& updatedTemplate);
+    void addTemplate(TaskTemplate templ);
+    bool updateTemplate(const std::string& name, TaskTemplate updatedTemplate);
     bool deleteTemplate(const std::string& name);
     int createTaskFromTemplate(const std::string& templateName);
     int createTaskFromTemplate(const std::string& templateName, const std::string& dueDate);
 
-    void addReminder(const Reminder& reminder);
+    void addReminder(Reminder reminder);
     bool removeReminder(int taskId);
     void checkReminders();
 
@@ -48,23 +88,36 @@ public:
     bool renameProjectGroup(const std::string& oldName, const std::string& newName);
     bool deleteProjectGroup(const std::string& groupName);
 
-    std::vector<Task> searchTasks(const std::string& keyword) const;
-    std::vector<Task> filterByCategory(const std::string& category) const;
-    std::vector<Task> filterByStatus(bool completed) const;
-    std::vector<Task> filterByDueDate(const std::string& date) const;
-    std::vector<Task> filterByTag(const std::string& tag) const;
-    std::vector<Task> filterByProjectGroup(const std::string& groupName) const;
+    TaskSelection searchTasks(const std::string& keyword) const;
+    SearchService::SearchPage searchPage(const std::string& query, const SearchService::SearchOptions& options,
+                                         const SearchService::PageRequest& page) const;
+    TaskSelection advancedSearch(const SearchService::SearchCriteria& criteria) const;
+    TaskSelection selectTasks(const TaskQuery& query) const;
+    TaskSelection filterByCategory(const std::string& category) const;
+    TaskSelection filterByStatus(bool completed) const;
+    TaskSelection filterByDueDate(const std::string& date) const;
+    TaskSelection filterByTag(const std::string& tag) const;
+    TaskSelection filterByProjectGroup(const std::string& groupName) const;
 
     void sortByPriority();
     void sortByDueDate();
     void sortByCategory();
+    // Сортировка по нескольким ключам, например "priority desc, dueDate".
+    void sortBy(const SortSpec& spec);
 
     void createRecurrentTaskCopy(int taskId);
 
+    bool loadSnapshot();
     bool loadFromJson();
-    bool saveToJson() const;
+    // Явный экспорт: полная перезапись tasks.json, при завершении не вызывается.
+    // Следом пишется контрольная точка, чтобы манифест остался новее tasks.json.
+    bool saveToJson();
+    bool loadFromSegments();
+    bool checkpoint();
 
-    const std::vector<Task>& getAllTasks() const { return tasks; }
+    const std::vector<Task>& getAllTasks() const { return tasks.all(); }
+    const TaskStore& getTaskStore() const { return tasks; }
+    const SearchIndex& getSearchIndex() const;
     const std::vector<Reminder>& getAllReminders() const { return reminders; }
     const std::map<std::string, TaskTemplate>& getAllTemplates() const { return templates; }
     const std::set<std::string>& getAllProjectGroups() const { return projectGroups; }
@@ -0,0 +1,99 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Приведение UTF-8 текста к нижнему регистру для поиска без учета регистра:
+// ASCII, Latin-1, Latin Extended-A, греческий и кириллица (включая Ё и
+// украинские, белорусские, сербские буквы). Каждая буква заменяется строчной
+// того же размера в байтах, поэтому длина и позиции в тексте не меняются, а
+// совпадение в сложенном тексте - совпадение в исходном. Некорректные
+// последовательности байтов остаются как есть.
+class CaseFolding {
+public:
+    static constexpr uint32_t foldCodepoint(uint32_t cp) {
+        if (cp >= 0xC0 && cp <= 0xDE && cp != 0xD7) {
+            return cp + 0x20;
+        }
+        if (cp >= 0x100 && cp <= 0x17F) {
+            if (cp == 0x130 || cp == 0x138 || cp == 0x149 || cp == 0x17F) {
+                return cp;
+            }
+            if (cp == 0x178) {
+                return 0xFF;
+            }
+            bool oddUpper = (cp >= 0x139 && cp <= 0x148) || (cp >= 0x179 && cp <= 0x17E);
+            return (cp % 2 == 1) == oddUpper ? cp + 1 : cp;
+        }
+        if (cp >= 0x391 && cp <= 0x3A9 && cp != 0x3A2) {
+            return cp + 0x20;
+        }
+        if (cp >= 0x400 && cp <= 0x40F) {
+            return cp + 0x50;
+        }
+        if (cp >= 0x410 && cp <= 0x42F) {
+            return cp + 0x20;
+        }
+        if ((cp >= 0x460 && cp <= 0x481) || (cp >= 0x48A && cp <= 0x4BF) || (cp >= 0x4D0 && cp <= 0x4FF)) {
+            return cp % 2 == 0 ? cp + 1 : cp;
+        }
+        if (cp == 0x4C0) {
+            return 0x4CF;
+        }
+        if (cp >= 0x4C1 && cp <= 0x4CE) {
+            return cp % 2 == 1 ? cp + 1 : cp;
+        }
+        return cp;
+    }
+
+    static void foldInPlace(char* data, size_t size) {
+        size_t i = 0;
+        while (i < size) {
+            unsigned char lead = static_cast<unsigned char>(data[i]);
+            if (lead < 0x80) {
+                if (lead >= 'A' && lead <= 'Z') {
+                    data[i] = static_cast<char>(lead + ('a' - 'A'));
+                }
+                i++;
+                continue;
+            }
+
+            // Все складываемые буквы за пределами ASCII - двухбайтовые.
+            if ((lead & 0xE0) == 0xC0 && i + 1 < size &&
+                (static_cast<unsigned char>(data[i + 1]) & 0xC0) == 0x80) {
+                uint32_t cp = (static_cast<uint32_t>(lead & 0x1F) << 6) |
+                              (static_cast<unsigned char>(data[i + 1]) & 0x3F);
+                uint32_t folded = foldCodepoint(cp);
+                if (folded != cp) {
+                    data[i] = static_cast<char>(0xC0 | (folded >> 6));
+                    data[i + 1] = static_cast<char>(0x80 | (folded & 0x3F));
+                }
+                i += 2;
+                continue;
+            }
+            i++;
+        }
+    }
+
+    static void foldInPlace(std::string& text) { foldInPlace(text.data(), text.size()); }
+
+    static std::string fold(std::string_view text) {
+        std::string result(text);
+        foldInPlace(result);
+        return result;
+    }
+
+    // Записывает сложенный text в buffer, сохраняя его емкость между вызовами.
+    static std::string_view foldInto(std::string_view text, std::string& buffer) {
+        buffer.assign(text);
+        foldInPlace(buffer);
+        return buffer;
+    }
+};
+
+static_assert(CaseFolding::foldCodepoint(0x401) == 0x451);
+static_assert(CaseFolding::foldCodepoint(0x42F) == 0x44F);
+static_assert(CaseFolding::foldCodepoint(0x490) == 0x491);
+static_assert(CaseFolding::foldCodepoint(0x178) == 0xFF);
+static_assert(CaseFolding::foldCodepoint(0x139) == 0x13A && CaseFolding::foldCodepoint(0x13A) == 0x13A);
@@ -0,0 +1,123 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Календарная дата как число дней от 1970-01-01. Преобразования в год/месяц/день
+// и обратно - алгоритмы civil_from_days/days_from_civil пролептического
+// григорианского календаря, без обращения к <ctime>. Строка "ГГГГ-ММ-ДД"
+// нужна только при вводе, выводе и сохранении в текстовые форматы.
+class Date {
+private:
+    int32_t dayNumber;
+
+public:
+    static constexpr int32_t NONE = std::numeric_limits<int32_t>::min();
+
+    struct Civil {
+        int year;
+        int month;
+        int day;
+    };
+
+    constexpr Date() : dayNumber(NONE) {}
+    constexpr explicit Date(int32_t dayNumber) : dayNumber(dayNumber) {}
+
+    static constexpr bool isLeapYear(int year) {
+        return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+    }
+
+    static constexpr int daysInMonth(int year, int month) {
+        constexpr int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        return month == 2 && isLeapYear(year) ? 29 : days[month - 1];
+    }
+
+    static constexpr bool isValidCivil(int year, int month, int day) {
+        return month >= 1 && month <= 12 && day >= 1 && day <= daysInMonth(year, month);
+    }
+
+    static constexpr Date fromCivil(int year, int month, int day) {
+        year -= month <= 2;
+        const int era = (year >= 0 ? year : year - 399) / 400;
+        const int yearOfEra = year - era * 400;
+        const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return Date(era * 146097 + dayOfEra - 719468);
+    }
+
+    // Строгий разбор "ГГГГ-ММ-ДД" с проверкой существования даты.
+    static constexpr std::optional<Date> parse(std::string_view text) {
+        if (text.size() != 10 || text[4] != '-' || text[7] != '-') {
+            return std::nullopt;
+        }
+
+        auto number = [&](size_t begin, size_t length, int& value) {
+            value = 0;
+            for (size_t i = begin; i < begin + length; ++i) {
+                if (text[i] < '0' || text[i] > '9') {
+                    return false;
+                }
+                value = value * 10 + (text[i] - '0');
+            }
+            return true;
+        };
+
+        int year = 0;
+        int month = 0;
+        int day = 0;
+        if (!number(0, 4, year) || !number(5, 2, month) || !number(8, 2, day) ||
+            !isValidCivil(year, month, day)) {
+            return std::nullopt;
+        }
+        return fromCivil(year, month, day);
+    }
+
+    static Date today();
+
+    constexpr bool isValid() const { return dayNumber != NONE; }
+    constexpr int32_t days() const { return dayNumber; }
+
+    constexpr Civil civil() const {
+        const int32_t shifted = dayNumber + 719468;
+        const int era = (shifted >= 0 ? shifted : shifted - 146096) / 146097;
+        const int dayOfEra = shifted - era * 146097;
+        const int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        const int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        const int monthIndex = (5 * dayOfYear + 2) / 153;
+        const int day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+        const int month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+        return {yearOfEra + era * 400 + (month <= 2), month, day};
+    }
+
+    // 0 - воскресенье, 6 - суббота (как tm_wday и RecurrenceRule::daysOfWeek).
+    constexpr int weekday() const {
+        return dayNumber >= -4 ? (dayNumber + 4) % 7 : (dayNumber + 5) % 7 + 6;
+    }
+
+    constexpr Date addDays(int count) const { return Date(dayNumber + count); }
+
+    // День месяца ограничивается длиной нового месяца: 31 января + 1 месяц = 28/29 февраля.
+    constexpr Date addMonths(int count) const {
+        Civil date = civil();
+        int monthIndex = date.year * 12 + (date.month - 1) + count;
+        int year = monthIndex >= 0 ? monthIndex / 12 : (monthIndex - 11) / 12;
+        int month = monthIndex - year * 12 + 1;
+        int day = date.day < daysInMonth(year, month) ? date.day : daysInMonth(year, month);
+        return fromCivil(year, month, day);
+    }
+
+    constexpr Date addYears(int count) const { return addMonths(count * 12); }
+
+    // Пустая строка для даты, которая не задана.
+    std::string toString() const;
+
+    constexpr auto operator<=>(const Date&) const = default;
+};
+
+static_assert(Date::fromCivil(1970, 1, 1).days() == 0);
+static_assert(Date::fromCivil(2000, 3, 1).civil().day == 1);
+static_assert(Date::fromCivil(1970, 1, 1).weekday() == 4);
+static_assert(Date::parse("2024-02-29").has_value() && !Date::parse("2023-02-29").has_value());
+static_assert(Date::fromCivil(2024, 1, 31).addMonths(1) == Date::fromCivil(2024, 2, 29));
@@ -0,0 +1,55 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Хеш-таблица с открытой адресацией (линейное пробирование) из ID в целое
+// значение: позицию задачи в векторе или ID родительской задачи. Удаление
+// сдвигает следующие записи назад, поэтому надгробия не нужны.
+class IdIndex {
+private:
+    struct Entry {
+        int id;
+        int value;
+    };
+
+    static constexpr int EMPTY = std::numeric_limits<int>::min();
+    static constexpr size_t MIN_CAPACITY = 16;
+
+    std::vector<Entry> entries;
+    size_t count;
+    unsigned shift;
+
+    size_t bucket(int id) const {
+        return static_cast<size_t>((static_cast<uint32_t>(id) * 2654435769u) >> shift);
+    }
+    size_t locate(int id) const;
+    void rehash(size_t capacity);
+
+public:
+    static constexpr int NOT_FOUND = -1;
+
+    IdIndex();
+
+    int find(int id) const;
+    // insert не заменяет существующую запись, assign - заменяет.
+    bool insert(int id, int value);
+    void assign(int id, int value);
+    bool erase(int id);
+    void clear();
+    void reserve(size_t size);
+
+    // Заменяет каждое значение на remap(value) одним последовательным проходом
+    // по таблице: дешевле, чем assign для каждого из многих ID.
+    template <typename Remap>
+    void remapValues(Remap&& remap) {
+        for (auto& entry : entries) {
+            if (entry.id != EMPTY) {
+                entry.value = remap(entry.value);
+            }
+        }
+    }
+
+    size_t size() const { return count; }
+};
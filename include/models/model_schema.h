@@ -0,0 +1,180 @@
+#pragma once
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <cstddef>
+#include "task.h"
+#include "template.h"
+#include "reminder.h"
+
+// Единое описание полей моделей. Из этих таблиц генерируются кодеки JSON,
+// двоичного снимка и CSV (services/schema_codec.h), поэтому новое поле
+// достаточно добавить только сюда.
+//
+// Порядок полей задает раскладку двоичного снимка: при любом изменении
+// таблиц нужно увеличить BinarySnapshot::VERSION.
+namespace Schema {
+
+enum Format : unsigned {
+    Json = 1,
+    Binary = 2,
+    Csv = 4,
+    All = Json | Binary | Csv,
+    // Не записывать поле в JSON, если список пуст или значение совпадает со значением
+    // в объекте, созданном конструктором по умолчанию. Вложенная модель с этим флагом
+    // в двоичном снимке предваряется байтом присутствия.
+    OmitDefault = 8
+};
+
+template <typename Accessor>
+struct AccessorTraits;
+
+template <typename Owner, typename Result>
+struct AccessorTraits<Result (Owner::*)() const> {
+    using OwnerType = Owner;
+    using ValueType = std::remove_cvref_t<Result>;
+};
+
+template <typename Owner, typename Value>
+    requires (!std::is_function_v<Value>)
+struct AccessorTraits<Value Owner::*> {
+    using OwnerType = Owner;
+    using ValueType = Value;
+};
+
+// Поле задается либо парой геттер/сеттер, либо указателем на открытый член.
+template <auto Getter, auto Setter>
+struct Field {
+    using Owner = typename AccessorTraits<decltype(Getter)>::OwnerType;
+    using Value = typename AccessorTraits<decltype(Getter)>::ValueType;
+
+    std::string_view name;
+    std::string_view label;
+    unsigned formats;
+
+    constexpr bool in(Format format) const { return (formats & format) != 0; }
+
+    static decltype(auto) get(const Owner& owner) {
+        if constexpr (std::is_member_function_pointer_v<decltype(Getter)>) {
+            return (owner.*Getter)();
+        } else {
+            return (owner.*Getter);
+        }
+    }
+
+    static void set(Owner& owner, Value&& value) {
+        if constexpr (std::is_member_function_pointer_v<decltype(Setter)>) {
+            (owner.*Setter)(std::move(value));
+        } else {
+            owner.*Setter = std::move(value);
+        }
+    }
+};
+
+template <auto Getter, auto Setter>
+constexpr Field<Getter, Setter> field(std::string_view name, std::string_view label, unsigned formats = All) {
+    return {name, label, formats};
+}
+
+template <auto Member>
+constexpr Field<Member, Member> member(std::string_view name, std::string_view label, unsigned formats = All) {
+    return {name, label, formats};
+}
+
+template <typename T>
+struct Model;
+
+template <typename T>
+concept Described = requires { Model<T>::fields; };
+
+template <>
+struct Model<RecurrenceRule> {
+    static constexpr auto fields = std::make_tuple(
+        member<&RecurrenceRule::type>("type", "Тип повторения"),
+        member<&RecurrenceRule::interval>("interval", "Интервал", All | OmitDefault),
+        member<&RecurrenceRule::daysOfWeek>("daysOfWeek", "Дни недели", All | OmitDefault),
+        member<&RecurrenceRule::dayOfMonth>("dayOfMonth", "День месяца", All | OmitDefault),
+        member<&RecurrenceRule::weekOfMonth>("weekOfMonth", "Неделя месяца", All | OmitDefault),
+        member<&RecurrenceRule::monthOfYear>("monthOfYear", "Месяц", All | OmitDefault),
+        member<&RecurrenceRule::endDate>("endDate", "Повторять до", All | OmitDefault),
+        member<&RecurrenceRule::maxOccurrences>("maxOccurrences", "Число повторений", All | OmitDefault)
+    );
+};
+
+// "recurrence" остается в JSON для совместимости со старыми файлами: при чтении
+// он идет раньше "recurrenceRule", и полное правило, если оно есть, его заменяет.
+// Вложенные списки "subtasks" старого формата разворачивает загрузчик
+// (JsonSaxLoader, FileService::jsonToTaskTree).
+template <>
+struct Model<Task> {
+    static constexpr auto fields = std::make_tuple(
+        field<&Task::getId, &Task::setId>("id", "ID"),
+        field<&Task::getParentId, &Task::setParentId>("parentId", "Родительская задача", Json | Binary | OmitDefault),
+        field<&Task::getDescription, &Task::setDescription>("description", "Описание"),
+        field<&Task::getDue, &Task::setDue>("dueDate", "Дата"),
+        field<&Task::getPriority, &Task::setPriority>("priority", "Приоритет"),
+        field<&Task::getCategorySymbol, &Task::setCategorySymbol>("category", "Категория"),
+        field<&Task::isCompleted, &Task::setCompleted>("completed", "Выполнена"),
+        field<&Task::getRecurrence, &Task::setRecurrence>("recurrence", "Повторение", Json),
+        field<&Task::getRecurrenceRule, &Task::setRecurrenceRule>("recurrenceRule", "Правило повторения",
+                                                                  All | OmitDefault),
+        field<&Task::getNotes, &Task::setNotes>("notes", "Примечания"),
+        field<&Task::getCreated, &Task::setCreated>("createdDate", "Дата создания"),
+        field<&Task::getProjectGroupSymbol, &Task::setProjectGroupSymbol>("projectGroup", "Группа проекта"),
+        field<&Task::getTagSymbols, &Task::setTagSymbols>("tags", "Теги")
+    );
+};
+
+template <>
+struct Model<Reminder> {
+    static constexpr auto fields = std::make_tuple(
+        field<&Reminder::getTaskId, &Reminder::setTaskId>("taskId", "ID задачи"),
+        field<&Reminder::getMessage, &Reminder::setMessage>("message", "Сообщение"),
+        field<&Reminder::isShown, &Reminder::setShown>("shown", "Показано"),
+        field<&Reminder::getTime, &Reminder::setTime>("time", "Время")
+    );
+};
+
+template <>
+struct Model<TaskTemplate> {
+    static constexpr auto fields = std::make_tuple(
+        field<&TaskTemplate::getName, &TaskTemplate::setName>("name", "Название"),
+        field<&TaskTemplate::getDescription, &TaskTemplate::setDescription>("description", "Описание"),
+        field<&TaskTemplate::getCategorySymbol, &TaskTemplate::setCategorySymbol>("category", "Категория"),
+        field<&TaskTemplate::getPriority, &TaskTemplate::setPriority>("priority", "Приоритет"),
+        field<&TaskTemplate::getRecurrence, &TaskTemplate::setRecurrence>("recurrence", "Повторение"),
+        field<&TaskTemplate::getNotes, &TaskTemplate::setNotes>("notes", "Примечания"),
+        field<&TaskTemplate::getProjectGroupSymbol, &TaskTemplate::setProjectGroupSymbol>(
+            "projectGroup", "Группа проекта"),
+        field<&TaskTemplate::getSubtaskDescriptions, &TaskTemplate::setSubtaskDescriptions>(
+            "subtaskDescriptions", "Подзадачи"),
+        field<&TaskTemplate::getTagSymbols, &TaskTemplate::setTagSymbols>("tags", "Теги")
+    );
+};
+
+template <typename T, typename Visitor>
+constexpr void forEachField(Visitor&& visitor) {
+    std::apply([&](const auto&... fields) { (visitor(fields), ...); }, Model<T>::fields);
+}
+
+template <typename T, typename Visitor>
+void visitField(size_t index, Visitor&& visitor) {
+    [&]<size_t... I>(std::index_sequence<I...>) {
+        ((index == I ? (visitor(std::get<I>(Model<T>::fields)), 0) : 0), ...);
+    }(std::make_index_sequence<std::tuple_size_v<decltype(Model<T>::fields)>>{});
+}
+
+template <typename T>
+int fieldIndex(std::string_view name) {
+    int index = 0;
+    int found = -1;
+    forEachField<T>([&](const auto& field) {
+        if (found < 0 && field.name == name) {
+            found = index;
+        }
+        index++;
+    });
+    return found;
+}
+
+}
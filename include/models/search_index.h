@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "task.h"
+#include "case_folding.h"
+
+class TaskStore;
+
+// Обратный индекс по текстовым полям задач (описание, категория, примечания,
+// теги): слово -> отсортированный список ID задач, в которых оно встречается.
+// Слово - непрерывная последовательность букв, цифр, '_' и байтов UTF-8 выше
+// 0x7F, в нижнем регистре (CaseFolding). Кроме списков хранится набор слов
+// каждой задачи, чтобы при изменении или удалении задачи убрать ее из старых
+// списков.
+//
+// Для поиска части слова словарь дополнительно разложен по триграммам:
+// тройка байтов -> номера слов, в которые она входит. Фрагмент из трех и
+// более байтов проверяется только на словах, содержащих все его триграммы,
+// а не на всем словаре. Триграммы строятся по словам, а не по всему тексту:
+// словарь на порядок меньше суммарного текста задач, а любое слово запроса
+// подстроки целиком лежит внутри одного слова текста.
+//
+// Индекс дает кандидатов, а не окончательный ответ: найденные задачи нужно
+// проверить исходным условием (регистр, целое слово, подстрока из нескольких
+// слов).
+class SearchIndex {
+private:
+    struct WordHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view word) const noexcept { return std::hash<std::string_view>{}(word); }
+    };
+
+    std::unordered_map<std::string, uint32_t, WordHash, std::equal_to<>> wordIds;
+    std::vector<std::string> words;
+    std::vector<std::vector<int>> postings;
+    std::unordered_map<int, std::vector<uint32_t>> documents;
+    std::unordered_map<uint32_t, std::vector<uint32_t>> trigramWords;
+    bool ready = false;
+
+    uint32_t wordId(std::string_view word);
+    void addTrigrams(uint32_t word);
+    // Номера слов словаря, содержащих fragment.
+    std::vector<uint32_t> wordsContaining(std::string_view fragment) const;
+    void addPosting(uint32_t word, int taskId);
+    void removePosting(uint32_t word, int taskId);
+    std::vector<uint32_t> collectWords(const Task& task);
+
+public:
+    static bool isWordByte(unsigned char c) {
+        return c >= 0x80 || c == '_' || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    // Вызывает visit(std::string_view) для каждого слова текста в нижнем регистре.
+    template <typename Visitor>
+    static void forEachWord(std::string_view text, Visitor&& visit) {
+        std::string word;
+        for (size_t i = 0; i <= text.size(); ++i) {
+            unsigned char c = i < text.size() ? static_cast<unsigned char>(text[i]) : ' ';
+            if (isWordByte(c)) {
+                word += static_cast<char>(c);
+            } else if (!word.empty()) {
+                CaseFolding::foldInPlace(word);
+                visit(std::string_view(word));
+                word.clear();
+            }
+        }
+    }
+
+    // Индекс строится при первом поиске; до этого изменения задач не отслеживаются.
+    bool isReady() const { return ready; }
+    void build(const TaskStore& store);
+    void clear();
+
+    // Добавление новой задачи или замена слов существующей.
+    void update(const Task& task);
+    void remove(int taskId);
+
+    // Задачи, содержащие слово целиком. Пустой список, если слова нет.
+    const std::vector<int>& exact(std::string_view word) const;
+    // Задачи, в которых есть слово, содержащее fragment как подстроку.
+    std::vector<int> containing(std::string_view fragment) const;
+    // Кандидаты для поиска подстроки query: в подходящей задаче каждое слово
+    // запроса входит в какое-то ее слово. nullopt, если в запросе нет ни
+    // одного слова и индекс ничего не сужает.
+    std::optional<std::vector<int>> substringCandidates(std::string_view query) const;
+    // Кандидаты для поиска по целым словам: объединение списков слов запроса.
+    std::optional<std::vector<int>> wordCandidates(std::string_view query) const;
+
+    static uint32_t trigram(std::string_view text, size_t pos) {
+        return (static_cast<uint32_t>(static_cast<unsigned char>(text[pos])) << 16) |
+               (static_cast<uint32_t>(static_cast<unsigned char>(text[pos + 1])) << 8) |
+               static_cast<uint32_t>(static_cast<unsigned char>(text[pos + 2]));
+    }
+
+    size_t wordCount() const { return words.size(); }
+    size_t documentCount() const { return documents.size(); }
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "task.h"
+#include "task_selection.h"
+
+// Порядок сортировки из нескольких ключей, например "priority desc, dueDate, id".
+// При равенстве всех ключей сохраняется исходный порядок (сортировка устойчива).
+//
+// Перед сортировкой значения ключей один раз переводятся в числа фиксированной
+// ширины: срок, приоритет, ID и статус - смещением от минимума (или от максимума
+// для убывания), категория - рангом среди встречающихся категорий по строке.
+// Ведущие ключи, суммарно умещающиеся в 64 бита, упаковываются в одно число, и
+// если упаковались все ключи, задачи сортируются поразрядно (LSD radix sort)
+// без сравнений. Описание и не уместившиеся ключи сравниваются уже после
+// упакованной части.
+class SortSpec {
+public:
+    enum class Field { Due, Priority, Category, Description, Id, Completed };
+
+    struct Key {
+        Field field;
+        bool ascending = true;
+    };
+
+private:
+    std::vector<Key> keys;
+
+    bool lessByKeys(const Task& a, const Task& b, size_t firstKey) const;
+    void sortRows(const std::vector<Task>& source, std::vector<uint32_t>& rows) const;
+
+public:
+    SortSpec() = default;
+    explicit SortSpec(std::vector<Key> keys) : keys(std::move(keys)) {}
+
+    // Список ключей через запятую: "поле [asc|desc]". Поля: dueDate (due),
+    // priority (prio), category (cat), description, id, completed (done).
+    // Направление по умолчанию - defaultAscending.
+    static std::optional<SortSpec> parse(std::string_view text, bool defaultAscending = true,
+                                         std::string* error = nullptr);
+
+    const std::vector<Key>& getKeys() const { return keys; }
+    // Тот же порядок с ID по возрастанию последним ключом (если ID среди
+    // ключей нет): равных задач в нем не остается.
+    SortSpec thenById() const;
+    std::string toString() const;
+
+    bool less(const Task& a, const Task& b) const { return lessByKeys(a, b, 0); }
+
+    // Номера задач tasks в отсортированном порядке.
+    std::vector<uint32_t> order(const std::vector<Task>& tasks) const;
+    void sort(TaskSelection& tasks) const;
+    void sort(std::vector<Task>& tasks) const;
+};
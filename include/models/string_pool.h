@@ -0,0 +1,160 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Общая таблица строк для повторяющихся значений (категории, теги, группы
+// проектов). Каждая строка хранится один раз, задачи держат только ее номер.
+// Строки никогда не удаляются и не перемещаются, поэтому ссылки, полученные
+// через get(), действительны до конца работы программы. Таблица используется
+// потоками параллельной загрузки, поиск идет под разделяемой блокировкой, а
+// чтение строки по номеру - без блокировки.
+//
+// Для каждой строки хранится и номер ее варианта в нижнем регистре
+// (CaseFolding), так что поиск без учета регистра по категориям и тегам не
+// складывает строки заново.
+class StringPool {
+private:
+    static constexpr size_t CHUNK_BITS = 12;
+    static constexpr size_t CHUNK_SIZE = size_t{1} << CHUNK_BITS;
+    static constexpr size_t MAX_CHUNKS = 4096;
+
+    struct Entry {
+        std::string text;
+        uint32_t folded = 0;
+    };
+
+    std::unique_ptr<std::atomic<Entry*>[]> chunks;
+    std::unordered_map<std::string_view, uint32_t> ids;
+    uint32_t count;
+    mutable std::shared_mutex mutex;
+
+    StringPool();
+
+    const Entry& entry(uint32_t id) const {
+        const Entry* chunk = chunks[id >> CHUNK_BITS].load(std::memory_order_acquire);
+        return chunk[id & (CHUNK_SIZE - 1)];
+    }
+    uint32_t insertLocked(std::string_view text);
+
+public:
+    static StringPool& getInstance();
+
+    ~StringPool();
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    // Номер 0 всегда соответствует пустой строке.
+    uint32_t intern(std::string_view text);
+    std::optional<uint32_t> find(std::string_view text) const;
+
+    const std::string& get(uint32_t id) const { return entry(id).text; }
+    uint32_t foldedId(uint32_t id) const { return entry(id).folded; }
+
+    size_t size() const;
+};
+
+// Строка из StringPool. Сравнение на равенство - сравнение номеров; порядок
+// по номерам не алфавитный, для сортировки нужно сравнивать str().
+class Symbol {
+private:
+    uint32_t id;
+
+public:
+    Symbol() : id(0) {}
+    explicit Symbol(std::string_view text) : id(StringPool::getInstance().intern(text)) {}
+
+    // Символ без добавления строки в таблицу: если строки там нет, ни одна
+    // задача не может ею обладать.
+    static std::optional<Symbol> lookup(std::string_view text) {
+        auto id = StringPool::getInstance().find(text);
+        if (!id) {
+            return std::nullopt;
+        }
+        Symbol symbol;
+        symbol.id = *id;
+        return symbol;
+    }
+
+    const std::string& str() const { return StringPool::getInstance().get(id); }
+    // Строка в нижнем регистре (CaseFolding).
+    const std::string& folded() const {
+        const StringPool& pool = StringPool::getInstance();
+        return pool.get(pool.foldedId(id));
+    }
+    uint32_t getId() const { return id; }
+    bool empty() const { return id == 0; }
+
+    bool operator==(const Symbol&) const = default;
+};
+
+template <>
+struct std::hash<Symbol> {
+    size_t operator()(Symbol symbol) const noexcept { return std::hash<uint32_t>{}(symbol.getId()); }
+};
+
+// Список символов, который читается как список строк (для циклов по тегам
+// без копирования). Приводится к std::vector<std::string> там, где нужна копия.
+class SymbolView {
+private:
+    const Symbol* first;
+    const Symbol* last;
+
+public:
+    class iterator {
+    private:
+        const Symbol* position;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string*;
+        using reference = const std::string&;
+
+        iterator() : position(nullptr) {}
+        explicit iterator(const Symbol* position) : position(position) {}
+
+        reference operator*() const { return position->str(); }
+        pointer operator->() const { return &position->str(); }
+        iterator& operator++() {
+            ++position;
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator previous = *this;
+            ++position;
+            return previous;
+        }
+        bool operator==(const iterator&) const = default;
+    };
+
+    explicit SymbolView(const std::vector<Symbol>& symbols)
+        : first(symbols.data()), last(symbols.data() + symbols.size()) {}
+
+    iterator begin() const { return iterator(first); }
+    iterator end() const { return iterator(last); }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+    const std::string& operator[](size_t index) const { return first[index].str(); }
+
+    operator std::vector<std::string>() const { return std::vector<std::string>(begin(), end()); }
+};
+
+inline std::vector<Symbol> internAll(const std::vector<std::string>& values) {
+    std::vector<Symbol> symbols;
+    symbols.reserve(values.size());
+    for (const auto& value : values) {
+        symbols.emplace_back(value);
+    }
+    return symbols;
+}
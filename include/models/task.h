@@ -1,8 +1,12 @@
 #pragma once
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 #include <chrono>
 #include <map>
+#include "date.h"
+#include "string_pool.h"
 
 enum class Recurrence {
     None,
@@ -39,41 +43,70 @@ struct RecurrenceRule {
                       weekOfMonth(0), monthOfYear(0), maxOccurrences(0) {}
 
     explicit RecurrenceRule(Recurrence oldRecurrence);
+
+    bool operator==(const RecurrenceRule&) const = default;
+};
+
+// Поля задачи для частичного обновления (Task::patch, TaskController::patchTask).
+namespace TaskFields {
+enum Mask : unsigned {
+    Description = 1,
+    DueDate = 2,
+    Priority = 4,
+    Category = 8,
+    Completed = 16,
+    Recurrence = 32,
+    Notes = 64,
+    Tags = 128,
+    ProjectGroup = 256,
+    All = Description | DueDate | Priority | Category | Completed | Recurrence | Notes | Tags | ProjectGroup
 };
+}
 
+// Подзадачи хранятся рядом с задачами в общем TaskStore и ссылаются на
+// родителя через parentId (0 - задача верхнего уровня).
 class Task {
 private:
     int id;
+    int parentId;
     std::string description;
-    std::string dueDate;
+    Date dueDate;
     int priority;
-    std::string category;
+    Symbol category;
     bool completed;
     RecurrenceRule recurrenceRule;
     std::string notes;
-    std::string createdDate;
-    std::string projectGroup;
-    std::vector<std::string> tags;
-    std::vector<Task> subtasks;
+    Date createdDate;
+    Symbol projectGroup;
+    std::vector<Symbol> tags;
 
 public:
     Task();
-    Task(const std::string& description, const std::string& dueDate);
+    Task(std::string description, std::string_view dueDate);
 
     int getId() const { return id; }
     void setId(int id) { this->id = id; }
 
+    int getParentId() const { return parentId; }
+    void setParentId(int parentId) { this->parentId = parentId; }
+    bool isSubtask() const { return parentId != 0; }
+
     const std::string& getDescription() const { return description; }
-    void setDescription(const std::string& description) { this->description = description; }
+    void setDescription(std::string description) { this->description = std::move(description); }
 
-    const std::string& getDueDate() const { return dueDate; }
-    void setDueDate(const std::string& dueDate) { this->dueDate = dueDate; }
+    Date getDue() const { return dueDate; }
+    void setDue(Date dueDate) { this->dueDate = dueDate; }
+    // Строковые варианты для ввода и вывода; нераспознанная строка дает пустую дату.
+    std::string getDueDate() const { return dueDate.toString(); }
+    void setDueDate(std::string_view dueDate) { this->dueDate = Date::parse(dueDate).value_or(Date()); }
 
     int getPriority() const { return priority; }
     void setPriority(int priority) { this->priority = priority; }
 
-    const std::string& getCategory() const { return category; }
-    void setCategory(const std::string& category) { this->category = category; }
+    const std::string& getCategory() const { return category.str(); }
+    void setCategory(std::string_view category) { this->category = Symbol(category); }
+    Symbol getCategorySymbol() const { return category; }
+    void setCategorySymbol(Symbol category) { this->category = category; }
 
     bool isCompleted() const { return completed; }
     void setCompleted(bool completed) { this->completed = completed; }
@@ -87,29 +120,36 @@ public:
     }
 
     const RecurrenceRule& getRecurrenceRule() const { return recurrenceRule; }
-    void setRecurrenceRule(const RecurrenceRule& rule) { recurrenceRule = rule; }
+    void setRecurrenceRule(RecurrenceRule rule) { recurrenceRule = std::move(rule); }
 
     const std::string& getNotes() const { return notes; }
-    void setNotes(const std::string& notes) { this->notes = notes; }
+    void setNotes(std::string notes) { this->notes = std::move(notes); }
 
-    const std::string& getCreatedDate() const { return createdDate; }
-    void setCreatedDate(const std::string& createdDate) { this->createdDate = createdDate; }
+    Date getCreated() const { return createdDate; }
+    void setCreated(Date createdDate) { this->createdDate = createdDate; }
+    std::string getCreatedDate() const { return createdDate.toString(); }
+    void setCreatedDate(std::string_view createdDate) {
+        this->createdDate = Date::parse(createdDate).value_or(Date());
+    }
 
-    const std::string& getProjectGroup() const { return projectGroup; }
-    void setProjectGroup(const std::string& projectGroup) { this->projectGroup = projectGroup; }
+    const std::string& getProjectGroup() const { return projectGroup.str(); }
+    void setProjectGroup(std::string_view projectGroup) { this->projectGroup = Symbol(projectGroup); }
+    Symbol getProjectGroupSymbol() const { return projectGroup; }
+    void setProjectGroupSymbol(Symbol projectGroup) { this->projectGroup = projectGroup; }
 
-    const std::vector<std::string>& getTags() const { return tags; }
-    void setTags(const std::vector<std::string>& tags) { this->tags = tags; }
-    void addTag(const std::string& tag);
-    void removeTag(const std::string& tag);
+    SymbolView getTags() const { return SymbolView(tags); }
+    void setTags(const std::vector<std::string>& tags) { this->tags = internAll(tags); }
+    const std::vector<Symbol>& getTagSymbols() const { return tags; }
+    void setTagSymbols(std::vector<Symbol> tags) { this->tags = std::move(tags); }
+    bool hasTag(Symbol tag) const;
+    void addTag(std::string_view tag);
+    void removeTag(std::string_view tag);
 
-    const std::vector<Task>& getSubtasks() const { return subtasks; }
-    void addSubtask(const Task& subtask);
-    void removeSubtask(int subtaskId);
-    Task* findSubtask(int subtaskId);
+    // Переносит из values поля, отмеченные в mask (TaskFields); values после этого не используется.
+    void patch(unsigned mask, Task&& values);
 
     bool isOverdue() const;
     bool isDueToday() const;
-    std::string getNextOccurrenceDate() const;
-    void setSubtasks(const std::vector<Task>& subtasks) { this->subtasks = subtasks; }
+    Date getNextOccurrence() const;
+    std::string getNextOccurrenceDate() const { return getNextOccurrence().toString(); }
 };
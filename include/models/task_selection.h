@@ -0,0 +1,130 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+#include "task.h"
+
+// Результат фильтра или поиска: номера подходящих задач в исходном векторе
+// (TaskStore::all() или переданном в SearchService) вместо их копий - по
+// 4 байта на задачу. Задачи читаются по ссылке при обходе; materialize()
+// копирует их, если результат нужен после изменения источника.
+//
+// Выборка действительна, пока исходный вектор не изменился: любое
+// добавление, удаление, сортировка или перезагрузка задач ее обесценивает.
+class TaskSelection {
+private:
+    const std::vector<Task>* source = nullptr;
+    std::vector<uint32_t> rows;
+
+public:
+    class const_iterator {
+    private:
+        const Task* base = nullptr;
+        const uint32_t* row = nullptr;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Task;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Task*;
+        using reference = const Task&;
+
+        const_iterator() = default;
+        const_iterator(const Task* base, const uint32_t* row) : base(base), row(row) {}
+
+        reference operator*() const { return base[*row]; }
+        pointer operator->() const { return base + *row; }
+        const_iterator& operator++() {
+            ++row;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++row;
+            return previous;
+        }
+        bool operator==(const const_iterator& other) const { return row == other.row; }
+        bool operator!=(const const_iterator& other) const { return row != other.row; }
+    };
+
+    TaskSelection() = default;
+    explicit TaskSelection(const std::vector<Task>& source) : source(&source) {}
+
+    // Все задачи источника в исходном порядке.
+    static TaskSelection all(const std::vector<Task>& source) {
+        TaskSelection selection(source);
+        selection.rows.resize(source.size());
+        for (size_t row = 0; row < source.size(); ++row) {
+            selection.rows[row] = static_cast<uint32_t>(row);
+        }
+        return selection;
+    }
+
+    void add(size_t row) { rows.push_back(static_cast<uint32_t>(row)); }
+    void reserve(size_t count) { rows.reserve(count); }
+
+    size_t size() const { return rows.size(); }
+    bool empty() const { return rows.empty(); }
+    const Task& operator[](size_t index) const { return (*source)[rows[index]]; }
+    // Позиция index-го результата в источнике (для хранилища - слот).
+    size_t rowAt(size_t index) const { return rows[index]; }
+    const std::vector<uint32_t>& getRows() const { return rows; }
+
+    const_iterator begin() const { return const_iterator(source ? source->data() : nullptr, rows.data()); }
+    const_iterator end() const { return const_iterator(source ? source->data() : nullptr, rows.data() + rows.size()); }
+
+    // Переставляет результаты; compare сравнивает сами задачи.
+    template <typename Compare>
+    void sort(Compare&& compare) {
+        const Task* base = source ? source->data() : nullptr;
+        std::sort(rows.begin(), rows.end(),
+                  [base, &compare](uint32_t a, uint32_t b) { return compare(base[a], base[b]); });
+    }
+
+    // Оставляет count первых по compare результатов в порядке сортировки:
+    // O(n log count) вместо полной сортировки.
+    template <typename Compare>
+    void partialSort(size_t count, Compare&& compare) {
+        const Task* base = source ? source->data() : nullptr;
+        auto byTask = [base, &compare](uint32_t a, uint32_t b) { return compare(base[a], base[b]); };
+        if (count >= rows.size()) {
+            std::sort(rows.begin(), rows.end(), byTask);
+            return;
+        }
+        std::partial_sort(rows.begin(), rows.begin() + static_cast<std::ptrdiff_t>(count), rows.end(), byTask);
+        rows.resize(count);
+    }
+
+    // Переставляет номера задач функцией reorder(source, rows).
+    template <typename Reorder>
+    void reorderRows(Reorder&& reorder) {
+        if (source) {
+            reorder(*source, rows);
+        }
+    }
+
+    template <typename Predicate>
+    void keepIf(Predicate&& predicate) {
+        const Task* base = source ? source->data() : nullptr;
+        rows.erase(std::remove_if(rows.begin(), rows.end(),
+                                  [base, &predicate](uint32_t row) { return !predicate(base[row]); }),
+                   rows.end());
+    }
+
+    void dropFront(size_t count) {
+        rows.erase(rows.begin(), rows.begin() + static_cast<std::ptrdiff_t>(std::min(count, rows.size())));
+    }
+
+    std::vector<int> ids() const {
+        std::vector<int> result;
+        result.reserve(rows.size());
+        for (const auto& task : *this) {
+            result.push_back(task.getId());
+        }
+        return result;
+    }
+
+    std::vector<Task> materialize() const { return std::vector<Task>(begin(), end()); }
+};
@@ -0,0 +1,188 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include "task.h"
+#include "id_index.h"
+#include "task_selection.h"
+#include "sort_spec.h"
+
+// Хранилище задач и подзадач любой вложенности. Полные объекты Task (описание,
+// примечания, теги) лежат в общем векторе, а поля, по которым идут фильтры и
+// сортировки, дополнительно разложены по отдельным плотным массивам. Проход
+// по одному столбцу не затрагивает остальные поля задач.
+//
+// Иерархия хранится позициями: родитель, первый ребенок и следующий брат.
+// Порядок детей совпадает с порядком хранения. Ссылки на отсутствующего
+// родителя и циклы при перестроении обнуляются, такие задачи становятся
+// задачами верхнего уровня.
+//
+// Столбцы, индекс ID и ссылки обновляются при каждом изменении через TaskStore
+// только для затронутых позиций; после правки задачи по указателю нужно вызвать
+// refresh(). Целиком они перестраиваются лишь при загрузке и сортировке.
+//
+// Для поиска без учета регистра хранятся копии описания и примечаний в нижнем
+// регистре (CaseFolding). Они строятся при первом обращении (prepareFolded) и
+// дальше обновляются вместе со столбцами; сортировка и загрузка их сбрасывают.
+class TaskStore {
+public:
+    static constexpr int NO_SLOT = -1;
+
+private:
+    std::vector<Task> tasks;
+    std::vector<int> ids;
+    std::vector<int32_t> dueDays;
+    std::vector<int> priorities;
+    std::vector<uint8_t> completedFlags;
+    std::vector<uint32_t> categories;
+    std::vector<uint32_t> groups;
+    std::vector<int> parents;
+    std::vector<int> firstChildren;
+    std::vector<int> nextSiblings;
+    IdIndex slots;
+    mutable std::vector<std::string> foldedDescriptions;
+    mutable std::vector<std::string> foldedNotes;
+    mutable bool foldedReady = false;
+
+    void writeColumns(size_t slot);
+    void rebuildColumns();
+    void relink();
+    bool detachCycles();
+    void linkChild(size_t slot);
+    void unlinkChild(size_t slot);
+    void detachChildren(size_t slot);
+    void writeFolded(size_t slot) const;
+    void dropFolded();
+
+public:
+    // Представление задачи для фильтров: горячие поля читаются из столбцов,
+    // остальные - из полного объекта.
+    class View {
+    private:
+        const TaskStore* store;
+        size_t slot;
+
+    public:
+        View(const TaskStore& store, size_t slot) : store(&store), slot(slot) {}
+
+        size_t getSlot() const { return slot; }
+        int getId() const { return store->ids[slot]; }
+        Date getDue() const { return Date(store->dueDays[slot]); }
+        int getPriority() const { return store->priorities[slot]; }
+        bool isCompleted() const { return store->completedFlags[slot] != 0; }
+        uint32_t getCategoryId() const { return store->categories[slot]; }
+        uint32_t getProjectGroupId() const { return store->groups[slot]; }
+
+        const Task& task() const { return store->tasks[slot]; }
+        const std::string& getDescription() const { return task().getDescription(); }
+        const std::string& getNotes() const { return task().getNotes(); }
+        const std::string& getCategory() const { return task().getCategory(); }
+        SymbolView getTags() const { return task().getTags(); }
+
+        // Только после TaskStore::prepareFolded().
+        const std::string& getFoldedDescription() const { return store->foldedDescriptions[slot]; }
+        const std::string& getFoldedNotes() const { return store->foldedNotes[slot]; }
+    };
+
+    size_t size() const { return tasks.size(); }
+    bool empty() const { return tasks.empty(); }
+
+    const std::vector<Task>& all() const { return tasks; }
+    std::vector<Task>::const_iterator begin() const { return tasks.begin(); }
+    std::vector<Task>::const_iterator end() const { return tasks.end(); }
+    const Task& operator[](size_t slot) const { return tasks[slot]; }
+    View view(size_t slot) const { return View(*this, slot); }
+
+    int slotOf(int id) const { return slots.find(id); }
+    void prepareFolded() const;
+    Task* find(int id);
+    const Task* find(int id) const;
+
+    // Загрузчики работают с обычным вектором: release() забирает задачи
+    // из хранилища, assign() возвращает их и перестраивает столбцы.
+    std::vector<Task> release();
+    void assign(std::vector<Task>&& loaded);
+    // Ссылка на добавленную задачу действительна до следующего изменения хранилища.
+    Task& push_back(Task task);
+    // Удаляет задачу вместе со всеми подзадачами, возвращает ID удаленных.
+    std::vector<int> erase(size_t slot);
+    void refresh(size_t slot);
+    void clear();
+    Task& edit(size_t slot) { return tasks[slot]; }
+
+    // Задачи, для которых предикат по представлению вернул true, в порядке хранения.
+    template <typename Predicate>
+    TaskSelection select(Predicate&& predicate) const {
+        TaskSelection results(tasks);
+        for (size_t slot = 0; slot < tasks.size(); ++slot) {
+            if (predicate(View(*this, slot))) {
+                results.add(slot);
+            }
+        }
+        return results;
+    }
+
+    // Сортирует все задачи; у каждого родителя дети идут в том же порядке.
+    template <typename Compare>
+    void sort(Compare&& compare) {
+        std::stable_sort(tasks.begin(), tasks.end(), compare);
+        dropFolded();
+        rebuildColumns();
+    }
+    void sortBy(const SortSpec& spec);
+
+    int parentOf(size_t slot) const { return parents[slot]; }
+    int firstChildOf(size_t slot) const { return firstChildren[slot]; }
+    int nextSiblingOf(size_t slot) const { return nextSiblings[slot]; }
+
+    template <typename Visitor>
+    void forEachRoot(Visitor&& visit) const {
+        for (size_t slot = 0; slot < tasks.size(); ++slot) {
+            if (parents[slot] == NO_SLOT) {
+                visit(tasks[slot]);
+            }
+        }
+    }
+
+    template <typename Visitor>
+    void forEachChild(size_t slot, Visitor&& visit) const {
+        for (int child = firstChildren[slot]; child != NO_SLOT; child = nextSiblings[child]) {
+            visit(tasks[child]);
+        }
+    }
+
+    // Обход поддерева в прямом порядке без самой задачи: visit(task, depth),
+    // depth = 1 для прямых подзадач. Идет по ссылкам, без стека.
+    template <typename Visitor>
+    void forEachDescendant(size_t slot, Visitor&& visit) const {
+        int current = firstChildren[slot];
+        int depth = 1;
+        while (current != NO_SLOT) {
+            visit(tasks[current], depth);
+            if (firstChildren[current] != NO_SLOT) {
+                current = firstChildren[current];
+                depth++;
+                continue;
+            }
+            while (current != NO_SLOT && nextSiblings[current] == NO_SLOT) {
+                current = parents[current];
+                depth--;
+                if (current == static_cast<int>(slot)) {
+                    return;
+                }
+            }
+            if (current != NO_SLOT) {
+                current = nextSiblings[current];
+            }
+        }
+    }
+
+    const std::vector<int>& idColumn() const { return ids; }
+    const std::vector<int32_t>& dueColumn() const { return dueDays; }
+    const std::vector<int>& priorityColumn() const { return priorities; }
+    const std::vector<uint8_t>& completedColumn() const { return completedFlags; }
+    const std::vector<uint32_t>& categoryColumn() const { return categories; }
+    const std::vector<uint32_t>& groupColumn() const { return groups; }
+};
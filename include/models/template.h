@@ -1,5 +1,7 @@
 #pragma once
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 #include "task.h"
 
@@ -7,26 +9,28 @@ class TaskTemplate {
 private:
     std::string name;
     std::string description;
-    std::string category;
+    Symbol category;
     int priority;
     Recurrence recurrence;
     std::string notes;
-    std::string projectGroup;
+    Symbol projectGroup;
     std::vector<std::string> subtaskDescriptions;
-    std::vector<std::string> tags;
+    std::vector<Symbol> tags;
 
 public:
     TaskTemplate();
-    TaskTemplate(const std::string& name, const std::string& description);
+    TaskTemplate(std::string name, std::string description);
 
     const std::string& getName() const { return name; }
-    void setName(const std::string& name) { this->name = name; }
+    void setName(std::string name) { this->name = std::move(name); }
 
     const std::string& getDescription() const { return description; }
-    void setDescription(const std::string& description) { this->description = description; }
+    void setDescription(std::string description) { this->description = std::move(description); }
 
-    const std::string& getCategory() const { return category; }
-    void setCategory(const std::string& category) { this->category = category; }
+    const std::string& getCategory() const { return category.str(); }
+    void setCategory(std::string_view category) { this->category = Symbol(category); }
+    Symbol getCategorySymbol() const { return category; }
+    void setCategorySymbol(Symbol category) { this->category = category; }
 
     int getPriority() const { return priority; }
     void setPriority(int priority) { this->priority = priority; }
@@ -35,17 +39,24 @@ public:
     void setRecurrence(Recurrence recurrence) { this->recurrence = recurrence; }
 
     const std::string& getNotes() const { return notes; }
-    void setNotes(const std::string& notes) { this->notes = notes; }
+    void setNotes(std::string notes) { this->notes = std::move(notes); }
 
-    const std::string& getProjectGroup() const { return projectGroup; }
-    void setProjectGroup(const std::string& projectGroup) { this->projectGroup = projectGroup; }
+    const std::string& getProjectGroup() const { return projectGroup.str(); }
+    void setProjectGroup(std::string_view projectGroup) { this->projectGroup = Symbol(projectGroup); }
+    Symbol getProjectGroupSymbol() const { return projectGroup; }
+    void setProjectGroupSymbol(Symbol projectGroup) { this->projectGroup = projectGroup; }
 
     const std::vector<std::string>& getSubtaskDescriptions() const { return subtaskDescriptions; }
-    void addSubtaskDescription(const std::string& description);
+    void setSubtaskDescriptions(std::vector<std::string> descriptions) { subtaskDescriptions = std::move(descriptions); }
+    void addSubtaskDescription(std::string description);
     void removeSubtaskDescription(int index);
 
-    const std::vector<std::string>& getTags() const { return tags; }
-    void setTags(const std::vector<std::string>& tags) { this->tags = tags; }
+    SymbolView getTags() const { return SymbolView(tags); }
+    void setTags(const std::vector<std::string>& tags) { this->tags = internAll(tags); }
+    const std::vector<Symbol>& getTagSymbols() const { return tags; }
+    void setTagSymbols(std::vector<Symbol> tags) { this->tags = std::move(tags); }
 
     Task createTask(const std::string& dueDate) const;
+    // Подзадачи для задачи, созданной createTask; ID и parentId назначает вызывающий.
+    std::vector<Task> createSubtasks(const Task& task) const;
 };
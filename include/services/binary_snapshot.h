@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Двоичный формат снимка (файлы сегментов). Все числа фиксированной ширины
+// записываются в порядке байт текущей платформы, что проверяется полем
+// byteOrderMark при загрузке.
+//
+// [Header][задачи][напоминания][шаблоны][uint32 смещение x (stringCount + 1)][таблица строк]
+//
+// Каждая секция записей - [блок фиксированной ширины x count][хвост переменной
+// длины]. Раскладку записей задают таблицы полей из models/model_schema.h (см.
+// Schema::writeRecord): скалярные поля читаются из блока по смещению, без разбора,
+// строки - через таблицу смещений, varint остаются только для списков и
+// вложенных моделей в хвосте. Подзадачи - отдельные записи со ссылкой parentId.
+namespace BinarySnapshot {
+
+constexpr char MAGIC[8] = {'T', 'M', 'S', 'N', 'A', 'P', '\0', '\0'};
+constexpr uint32_t VERSION = 6;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark;
+    int64_t journalSequence;
+    uint32_t taskCount;
+    uint32_t reminderCount;
+    uint32_t templateCount;
+    uint32_t stringCount;
+    uint64_t taskOffset;
+    uint64_t reminderOffset;
+    uint64_t templateOffset;
+    uint64_t stringIndexOffset;
+    uint64_t stringTableOffset;
+    uint64_t stringTableSize;
+};
+
+// Манифест сегментированного хранилища (<данные>.segments/manifest.bin):
+// [ManifestHeader][ManifestSegment x segmentCount][int32 id x orderCount]
+// order хранит порядок задач и подзадач, каждый сегмент - обычный снимок.
+constexpr char MANIFEST_MAGIC[8] = {'T', 'M', 'M', 'A', 'N', 'I', 'F', '\0'};
+constexpr uint32_t MANIFEST_VERSION = 1;
+
+struct ManifestHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark;
+    int64_t journalSequence;
+    uint32_t segmentSize;
+    uint32_t segmentCount;
+    uint32_t orderCount;
+    uint32_t reserved;
+};
+
+struct ManifestSegment {
+    int32_t key;
+    uint32_t reserved;
+    int64_t fileSequence;
+};
+
+static_assert(sizeof(Header) == 88, "BinarySnapshot::Header layout changed");
+static_assert(sizeof(ManifestHeader) == 40, "BinarySnapshot::ManifestHeader layout changed");
+static_assert(sizeof(ManifestSegment) == 16, "BinarySnapshot::ManifestSegment layout changed");
+
+}
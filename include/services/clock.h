@@ -0,0 +1,46 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "../models/date.h"
+
+// Текущее время для всего приложения. Разбор момента в местное время
+// (localtime) выполняется один раз на минуту: пока время не вышло за пределы
+// закэшированной минуты, день, часы и минуты берутся из кэша, секунды
+// досчитываются. Кэш свой у каждого потока, блокировок нет.
+//
+// Источник времени можно подменить (setSource, freeze), чтобы получить
+// предсказуемые "сегодня" и "сейчас". Кэш привязан к самому моменту, а не к
+// источнику, поэтому после подмены он остается верным.
+class Clock {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+    using Source = std::function<TimePoint()>;
+
+    // Разобранная местная минута.
+    struct LocalMinute {
+        int64_t start = 0;      // начало минуты, секунды от эпохи
+        Date day;
+        int hour = 0;
+        int minute = 0;
+        char text[60] = {};     // "ГГГГ-ММ-ДД ЧЧ:ММ"; размер - под любые int полей
+    };
+
+    static TimePoint now();
+    static Date today();
+    // "ГГГГ-ММ-ДД" для текущего дня.
+    static std::string todayString();
+
+    // Местная минута, в которую попадает момент time. Повторные вызовы в
+    // пределах той же минуты не обращаются к localtime.
+    static const LocalMinute& localMinute(TimePoint time);
+    // "ГГГГ-ММ-ДД ЧЧ:ММ" и "ГГГГ-ММ-ДД ЧЧ:ММ:СС.ммм" в местном времени.
+    static std::string formatMinute(TimePoint time);
+    static std::string formatMillis(TimePoint time);
+
+    static void setSource(Source source);
+    static void resetSource();
+    // Фиксированное время вместо системного.
+    static void freeze(TimePoint time);
+};
@@ -2,22 +2,30 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <iostream>
 #include "../models/task.h"
+#include "../models/task_store.h"
 #include "../models/template.h"
 
 class ExportService {
 public:
-    static bool exportToMarkdown(const std::vector<Task>& tasks, const std::string& filename);
-    static bool exportToICS(const std::vector<Task>& tasks, const std::string& filename);
-    static bool exportToCSV(const std::vector<Task>& tasks, const std::string& filename);
-    static bool exportToHTML(const std::vector<Task>& tasks, const std::string& filename);
+    static bool exportToMarkdown(const TaskStore& tasks, const std::string& filename);
+    static bool exportToICS(const TaskStore& tasks, const std::string& filename);
+    static bool exportToCSV(const TaskStore& tasks, const std::string& filename);
+    static bool importFromCSV(const std::string& filename, std::vector<Task>& tasks);
+    static bool exportToHTML(const TaskStore& tasks, const std::string& filename);
     static bool exportTemplates(const std::map<std::string, TaskTemplate>& templates,
                                 const std::string& filename);
     static bool importTemplates(const std::string& filename,
                                 std::map<std::string, TaskTemplate>& templates);
 
 private:
+    static constexpr const char* CSV_PARENT_COLUMN = "Родительская задача";
+
     static std::string escapeCSV(const std::string& str);
+    static void writeCSVRow(std::ostream& out, const std::vector<std::string>& cells);
+    static bool readCSVRow(std::istream& in, std::vector<std::string>& cells);
     static std::string convertDateToICS(const std::string& date);
+    static std::string buildRRule(const RecurrenceRule& rule);
     static std::string getCurrentDate();
 };
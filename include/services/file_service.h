@@ -2,6 +2,8 @@
 #include <string>
 #include <vector>
 #include <set>
+#include <map>
+#include <cstdint>
 #include <nlohmann/json.hpp>
 #include "../models/task.h"
 #include "../models/template.h"
@@ -9,6 +11,24 @@
 
 class FileService {
 public:
+    struct SegmentManifest {
+        static constexpr int32_t REMINDERS_SEGMENT = -1;
+        static constexpr int32_t TEMPLATES_SEGMENT = -2;
+
+        int64_t journalSequence = 0;
+        uint32_t segmentSize = 0;
+        std::map<int32_t, int64_t> segments;
+        std::vector<int32_t> order;
+    };
+
+    struct SegmentData {
+        std::vector<Task> tasks;
+        std::vector<Reminder> reminders;
+        std::map<std::string, TaskTemplate> templates;
+
+        bool empty() const { return tasks.empty() && reminders.empty() && templates.empty(); }
+    };
+
     static bool loadFromJson(const std::string& filename,
                              std::vector<Task>& tasks,
                              std::vector<Reminder>& reminders,
@@ -16,11 +36,49 @@ public:
                              std::set<std::string>& projectGroups,
                              int& nextId);
 
+    static bool loadFromJson(const std::string& filename,
+                             std::vector<Task>& tasks,
+                             std::vector<Reminder>& reminders,
+                             std::map<std::string, TaskTemplate>& templates,
+                             std::set<std::string>& projectGroups,
+                             int& nextId,
+                             int64_t& journalSequence);
+
     static bool saveToJson(const std::string& filename,
                            const std::vector<Task>& tasks,
                            const std::vector<Reminder>& reminders,
                            const std::map<std::string, TaskTemplate>& templates,
-                           const std::set<std::string>& projectGroups);
+                           const std::set<std::string>& projectGroups,
+                           int64_t journalSequence = 0);
+
+    static std::string serializeToJson(const std::vector<Task>& tasks,
+                                       const std::vector<Reminder>& reminders,
+                                       const std::map<std::string, TaskTemplate>& templates,
+                                       int64_t journalSequence);
+
+    static std::string serializeToBinary(const std::vector<Task>& tasks,
+                                         const std::vector<Reminder>& reminders,
+                                         const std::map<std::string, TaskTemplate>& templates,
+                                         int64_t journalSequence);
+
+    static std::string segmentFileName(int32_t key, int64_t fileSequence);
+
+    static bool saveSegments(const std::string& directory,
+                             const SegmentManifest& manifest,
+                             const std::map<int32_t, SegmentData>& changedSegments);
+
+    // Сегменты с другим размером (segmentSize задач на файл) не загружаются:
+    // раскладка задач по файлам для них не совпадет.
+    static bool loadSegments(const std::string& directory,
+                             uint32_t segmentSize,
+                             std::vector<Task>& tasks,
+                             std::vector<Reminder>& reminders,
+                             std::map<std::string, TaskTemplate>& templates,
+                             std::set<std::string>& projectGroups,
+                             int& nextId,
+                             SegmentManifest& manifest);
+
+    static bool writeFileAtomically(const std::string& filename, const std::string& data);
 
     static bool createBackup(const std::string& originalFile, const std::string& backupFile);
     static bool restoreFromBackup(const std::string& backupFile, const std::string& targetFile);
@@ -28,6 +86,8 @@ public:
 
     static nlohmann::json taskToJson(const Task& task);
     static Task jsonToTask(const nlohmann::json& json);
+    // Задача и ее подзадачи в плоском виде; понимает и вложенные "subtasks" старого формата.
+    static std::vector<Task> jsonToTaskTree(const nlohmann::json& json);
 
     static nlohmann::json reminderToJson(const Reminder& reminder);
     static Reminder jsonToReminder(const nlohmann::json& json);
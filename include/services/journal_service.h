@@ -0,0 +1,50 @@
+#pragma once
+#include <string>
+#include <fstream>
+#include <functional>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// Журнал изменений (write-ahead log): по одной компактной JSON-записи на строку.
+// Каждая запись получает возрастающий номер "seq"; снимок хранит номер последней
+// учтенной записи, поэтому при воспроизведении более старые записи пропускаются.
+// При контрольной точке текущий файл переименовывается в сегмент "<журнал>.<seq>",
+// который удаляется после того, как снимок с этим номером надежно записан.
+//
+// Каждая запись сбрасывается на диск (fsync) до возврата из append(): изменение,
+// для которого append() вернул true, переживает и сбой питания. Если запись или
+// fsync не удались, файл обрезается до прежнего размера и номер не расходуется.
+class JournalService {
+private:
+    std::string journalFilePath;
+#ifdef _WIN32
+    std::ofstream journalFile;
+#else
+    int journalFd;
+#endif
+    int64_t lastSequence;
+    size_t recordCount;
+
+    std::mutex segmentMutex;
+
+    bool openForAppend();
+    void closeFile();
+    std::vector<std::pair<int64_t, std::string>> listSegments() const;
+    size_t replayFile(const std::string& filename, int64_t afterSequence,
+                      const std::function<void(const nlohmann::json&)>& apply, size_t& records);
+
+public:
+    explicit JournalService(const std::string& journalFile);
+    ~JournalService();
+
+    bool append(nlohmann::json record);
+    size_t replay(int64_t afterSequence, const std::function<void(const nlohmann::json&)>& apply);
+    bool rotate();
+    void removeSegmentsUpTo(int64_t sequence);
+
+    int64_t getLastSequence() const { return lastSequence; }
+    size_t getRecordCount() const { return recordCount; }
+    const std::string& getFilePath() const { return journalFilePath; }
+};
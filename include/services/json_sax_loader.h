@@ -0,0 +1,60 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "../models/task.h"
+#include "../models/template.h"
+#include "../models/reminder.h"
+#include "schema_codec.h"
+
+// Потоковый загрузчик tasks.json: объекты Task, Reminder и TaskTemplate
+// собираются прямо во время разбора, без построения DOM всего файла.
+// Разбор отдельных записей генерируется по таблицам полей (Schema::ObjectSink).
+// Вложенные "subtasks" старого формата разворачиваются в плоский список задач.
+//
+// Загрузчик, созданный только со списком задач, разбирает один элемент массива
+// "tasks" (корневой объект - задача); так работает параллельная загрузка.
+class JsonSaxLoader : public nlohmann::json_sax<nlohmann::json> {
+private:
+    class DocumentSink;
+
+    std::vector<Task>& tasks;
+    std::vector<Reminder>* reminders;
+    std::map<std::string, TaskTemplate>* templates;
+
+    std::vector<std::unique_ptr<Schema::SaxSink>> sinks;
+    int64_t journalSequence;
+    std::string errorMessage;
+
+    bool scalar(Schema::JsonScalar& value);
+    bool open(bool array);
+    bool close();
+
+public:
+    JsonSaxLoader(std::vector<Task>& tasks,
+                  std::vector<Reminder>& reminders,
+                  std::map<std::string, TaskTemplate>& templates);
+    explicit JsonSaxLoader(std::vector<Task>& tasks);
+    ~JsonSaxLoader() override;
+
+    int64_t getJournalSequence() const { return journalSequence; }
+    const std::string& getErrorMessage() const { return errorMessage; }
+
+    bool null() override;
+    bool boolean(bool value) override;
+    bool number_integer(number_integer_t value) override;
+    bool number_unsigned(number_unsigned_t value) override;
+    bool number_float(number_float_t value, const string_t& text) override;
+    bool string(string_t& value) override;
+    bool binary(binary_t& value) override;
+    bool start_object(std::size_t elements) override;
+    bool key(string_t& value) override;
+    bool end_object() override;
+    bool start_array(std::size_t elements) override;
+    bool end_array() override;
+    bool parse_error(std::size_t position, const std::string& lastToken,
+                     const nlohmann::detail::exception& ex) override;
+};
@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Регулярное выражение ECMAScript для поиска по задачам. Выражение один раз
+// переводится в НКА (конструкция Томпсона), а при поиске по нему лениво
+// строится ДКА: каждое новое множество состояний НКА превращается в состояние
+// ДКА с таблицей переходов по байтам, так что повторные проходы по тексту
+// идут по готовой таблице без возвратов.
+//
+// Поддерживаются литералы, '.', классы [...], \d \w \s и их отрицания,
+// группы, альтернатива, квантификаторы * + ? {m,n} (ленивые тоже - для
+// поиска без захвата они равносильны жадным), ^ и $. Для обратных ссылок,
+// \b, просмотра вперед и прочего используется std::regex. Сравнение побайтовое;
+// без учета регистра литералы и классы выражения складываются через
+// CaseFolding, и ДКА идет по так же сложенному тексту, поэтому "отчёт"
+// находит "Отчёт". std::regex в запасном пути учитывает регистр только для
+// ASCII, как с локалью "C".
+//
+// Скомпилированные выражения кэшируются (compile). Объект хранит
+// достраиваемый ДКА, поэтому один объект нельзя использовать из нескольких
+// потоков одновременно.
+class RegexMatcher {
+private:
+    struct NfaState {
+        enum Type { Byte, Split, Begin, End, Match };
+        Type type;
+        int set;
+        int out;
+        int out1;
+    };
+
+    struct DfaState {
+        std::vector<int> nfa;
+        bool match;
+        bool matchAtEnd;
+        std::array<int, 256> next;
+    };
+
+    static constexpr int UNKNOWN = -1;
+    static constexpr size_t MAX_DFA_STATES = 2048;
+
+    bool caseSensitive;
+    std::optional<std::regex> fallback;
+
+    std::vector<NfaState> nfa;
+    std::vector<std::bitset<256>> sets;
+    int nfaStart;
+    bool matchesEmpty;
+
+    std::vector<DfaState> dfa;
+    std::map<std::vector<int>, int> dfaIndex;
+    int dfaStart;
+
+    std::vector<int> visitMarks;
+    int visitGeneration;
+    std::string foldBuffer;
+
+    RegexMatcher(const std::string& pattern, bool caseSensitive);
+
+    bool buildNfa(const std::string& pattern);
+    void closure(std::vector<int>& stack, bool atBegin, bool atEnd, std::vector<int>& result);
+    int dfaState(std::vector<int> states);
+    int step(int state, unsigned char byte);
+
+public:
+    // Выражение из кэша или новое; nullptr, если выражение некорректно.
+    static std::shared_ptr<RegexMatcher> compile(const std::string& pattern, bool caseSensitive);
+
+    bool search(std::string_view text);
+    // Текст уже сложен CaseFolding (сложенные копии TaskStore). Только для
+    // выражения без учета регистра, которое идет через ДКА (usesDfa()).
+    bool searchFolded(std::string_view text);
+    bool usesDfa() const { return !fallback; }
+};
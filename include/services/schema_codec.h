@@ -0,0 +1,830 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+#include "../models/model_schema.h"
+
+// Кодеки, построенные по таблицам полей из models/model_schema.h:
+// JSON (DOM, потоковая запись и SAX-приемники), двоичный снимок и строки CSV.
+namespace Schema {
+
+using TimePoint = std::chrono::system_clock::time_point;
+
+template <typename V>
+struct IsVector : std::false_type {};
+
+template <typename E>
+struct IsVector<std::vector<E>> : std::true_type {};
+
+template <typename V>
+concept Scalar = std::is_arithmetic_v<V> || std::is_enum_v<V> || std::is_same_v<V, std::string> ||
+                 std::is_same_v<V, TimePoint> || std::is_same_v<V, Date> || std::is_same_v<V, Symbol>;
+
+template <typename V>
+concept List = IsVector<V>::value;
+
+// Значения, которые помещаются в одну ячейку CSV: скаляры и списки скаляров.
+template <typename V>
+concept CellValue = Scalar<V> || (List<V> && Scalar<typename V::value_type>);
+
+template <Described T>
+const T& defaultInstance() {
+    static const T instance{};
+    return instance;
+}
+
+template <typename F>
+bool isDefault(const F& field, const typename F::Value& value) {
+    if constexpr (List<typename F::Value>) {
+        return value.empty();
+    } else {
+        return value == field.get(defaultInstance<typename F::Owner>());
+    }
+}
+
+std::string formatTime(TimePoint time);
+TimePoint parseTime(const std::string& text);
+
+// ---------- JSON: DOM ----------
+
+template <Described T>
+nlohmann::json toJson(const T& object);
+
+template <Described T>
+T fromJson(const nlohmann::json& j);
+
+template <typename V>
+nlohmann::json toJsonValue(const V& value) {
+    if constexpr (Described<V>) {
+        return toJson(value);
+    } else if constexpr (List<V>) {
+        nlohmann::json array = nlohmann::json::array();
+        for (const auto& element : value) {
+            array.push_back(toJsonValue(element));
+        }
+        return array;
+    } else if constexpr (std::is_enum_v<V>) {
+        return static_cast<int>(value);
+    } else if constexpr (std::is_same_v<V, TimePoint>) {
+        return formatTime(value);
+    } else if constexpr (std::is_same_v<V, Date>) {
+        return value.toString();
+    } else if constexpr (std::is_same_v<V, Symbol>) {
+        return value.str();
+    } else {
+        return value;
+    }
+}
+
+template <typename V>
+bool fromJsonValue(const nlohmann::json& j, V& value) {
+    if constexpr (Described<V>) {
+        if (!j.is_object()) {
+            return false;
+        }
+        value = fromJson<V>(j);
+    } else if constexpr (List<V>) {
+        if (!j.is_array()) {
+            return false;
+        }
+        value.clear();
+        value.reserve(j.size());
+        for (const auto& item : j) {
+            typename V::value_type element{};
+            if (fromJsonValue(item, element)) {
+                value.push_back(std::move(element));
+            }
+        }
+    } else if constexpr (std::is_same_v<V, bool>) {
+        if (!j.is_boolean()) {
+            return false;
+        }
+        value = j.get<bool>();
+    } else if constexpr (std::is_enum_v<V> || std::is_integral_v<V>) {
+        if (!j.is_number_integer()) {
+            return false;
+        }
+        value = static_cast<V>(j.get<int64_t>());
+    } else if constexpr (std::is_floating_point_v<V>) {
+        if (!j.is_number()) {
+            return false;
+        }
+        value = j.get<V>();
+    } else if constexpr (std::is_same_v<V, TimePoint>) {
+        if (!j.is_string()) {
+            return false;
+        }
+        value = parseTime(j.get_ref<const std::string&>());
+    } else if constexpr (std::is_same_v<V, Date>) {
+        if (!j.is_string()) {
+            return false;
+        }
+        value = Date::parse(j.get_ref<const std::string&>()).value_or(Date());
+    } else if constexpr (std::is_same_v<V, Symbol>) {
+        if (!j.is_string()) {
+            return false;
+        }
+        value = Symbol(j.get_ref<const std::string&>());
+    } else {
+        if (!j.is_string()) {
+            return false;
+        }
+        value = j.get<std::string>();
+    }
+    return true;
+}
+
+template <Described T>
+nlohmann::json toJson(const T& object) {
+    nlohmann::json j = nlohmann::json::object();
+    forEachField<T>([&](const auto& field) {
+        if (!field.in(Json)) {
+            return;
+        }
+        const auto& value = field.get(object);
+        if (field.in(OmitDefault) && isDefault(field, value)) {
+            return;
+        }
+        j[std::string(field.name)] = toJsonValue(value);
+    });
+    return j;
+}
+
+template <Described T>
+T fromJson(const nlohmann::json& j) {
+    T object{};
+    forEachField<T>([&](const auto& field) {
+        using F = std::remove_cvref_t<decltype(field)>;
+        if (!field.in(Json)) {
+            return;
+        }
+        auto it = j.find(field.name);
+        if (it == j.end()) {
+            return;
+        }
+        typename F::Value value{};
+        if (fromJsonValue(*it, value)) {
+            F::set(object, std::move(value));
+        }
+    });
+    return object;
+}
+
+// ---------- JSON: потоковая запись ----------
+
+// Пишет JSON в том же виде, что и nlohmann::json::dump(indent), но без DOM.
+// Некорректные последовательности UTF-8 заменяются на U+FFFD.
+class JsonWriter {
+private:
+    std::string& out;
+    int indent;
+    std::vector<bool> emptyScopes;
+    bool afterKey;
+
+    void element();
+    void newline();
+
+public:
+    explicit JsonWriter(std::string& out, int indent = 4);
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+    void key(std::string_view name);
+
+    void string(std::string_view value);
+    void integer(int64_t value);
+    void number(double value);
+    void boolean(bool value);
+};
+
+template <Described T>
+void writeJson(JsonWriter& writer, const T& object);
+
+template <typename V>
+void writeJsonValue(JsonWriter& writer, const V& value) {
+    if constexpr (Described<V>) {
+        writeJson(writer, value);
+    } else if constexpr (List<V>) {
+        writer.beginArray();
+        for (const auto& element : value) {
+            writeJsonValue(writer, element);
+        }
+        writer.endArray();
+    } else if constexpr (std::is_same_v<V, bool>) {
+        writer.boolean(value);
+    } else if constexpr (std::is_enum_v<V> || std::is_integral_v<V>) {
+        writer.integer(static_cast<int64_t>(value));
+    } else if constexpr (std::is_floating_point_v<V>) {
+        writer.number(value);
+    } else if constexpr (std::is_same_v<V, TimePoint>) {
+        writer.string(formatTime(value));
+    } else if constexpr (std::is_same_v<V, Date>) {
+        writer.string(value.toString());
+    } else if constexpr (std::is_same_v<V, Symbol>) {
+        writer.string(value.str());
+    } else {
+        writer.string(value);
+    }
+}
+
+template <Described T>
+void writeJson(JsonWriter& writer, const T& object) {
+    writer.beginObject();
+    forEachField<T>([&](const auto& field) {
+        if (!field.in(Json)) {
+            return;
+        }
+        const auto& value = field.get(object);
+        if (field.in(OmitDefault) && isDefault(field, value)) {
+            return;
+        }
+        writer.key(field.name);
+        writeJsonValue(writer, value);
+    });
+    writer.endObject();
+}
+
+// ---------- JSON: SAX ----------
+
+struct JsonScalar {
+    enum class Kind { Null, Boolean, Integer, Float, String };
+
+    Kind kind = Kind::Null;
+    bool boolean = false;
+    int64_t integer = 0;
+    double number = 0.0;
+    std::string* text = nullptr;
+};
+
+// Приемник событий SAX для одного JSON-объекта или массива. nested() возвращает
+// приемник для вложенного значения или nullptr, если его нужно пропустить.
+class SaxSink {
+public:
+    virtual ~SaxSink() = default;
+    virtual void key(std::string&) {}
+    virtual void scalar(JsonScalar&) {}
+    virtual std::unique_ptr<SaxSink> nested(bool) { return nullptr; }
+    virtual void close() {}
+};
+
+template <typename V>
+bool assignScalar(JsonScalar& scalar, V& value) {
+    using Kind = JsonScalar::Kind;
+    if constexpr (std::is_same_v<V, bool>) {
+        if (scalar.kind != Kind::Boolean) {
+            return false;
+        }
+        value = scalar.boolean;
+    } else if constexpr (std::is_enum_v<V> || std::is_integral_v<V>) {
+        if (scalar.kind != Kind::Integer) {
+            return false;
+        }
+        value = static_cast<V>(scalar.integer);
+    } else if constexpr (std::is_floating_point_v<V>) {
+        if (scalar.kind == Kind::Integer) {
+            value = static_cast<V>(scalar.integer);
+        } else if (scalar.kind == Kind::Float) {
+            value = static_cast<V>(scalar.number);
+        } else {
+            return false;
+        }
+    } else if constexpr (std::is_same_v<V, TimePoint>) {
+        if (scalar.kind != Kind::String) {
+            return false;
+        }
+        value = parseTime(*scalar.text);
+    } else if constexpr (std::is_same_v<V, Date>) {
+        if (scalar.kind != Kind::String) {
+            return false;
+        }
+        value = Date::parse(*scalar.text).value_or(Date());
+    } else if constexpr (std::is_same_v<V, Symbol>) {
+        if (scalar.kind != Kind::String) {
+            return false;
+        }
+        value = Symbol(*scalar.text);
+    } else {
+        if (scalar.kind != Kind::String) {
+            return false;
+        }
+        value = std::move(*scalar.text);
+    }
+    return true;
+}
+
+template <typename V>
+std::unique_ptr<SaxSink> makeSink(bool array, std::function<void(V&&)> done);
+
+template <typename E>
+class ArraySink : public SaxSink {
+private:
+    std::vector<E> values;
+    std::function<void(std::vector<E>&&)> done;
+
+public:
+    explicit ArraySink(std::function<void(std::vector<E>&&)> done) : done(std::move(done)) {}
+
+    void scalar(JsonScalar& scalar) override {
+        if constexpr (Scalar<E>) {
+            E value{};
+            if (assignScalar(scalar, value)) {
+                values.push_back(std::move(value));
+            }
+        }
+    }
+
+    std::unique_ptr<SaxSink> nested(bool array) override {
+        return makeSink<E>(array, [this](E&& value) { values.push_back(std::move(value)); });
+    }
+
+    void close() override { done(std::move(values)); }
+};
+
+template <Described T>
+class ObjectSink : public SaxSink {
+private:
+    T object{};
+    int field = -1;
+    std::function<void(T&&)> done;
+
+public:
+    explicit ObjectSink(std::function<void(T&&)> done) : done(std::move(done)) {}
+
+    void key(std::string& name) override { field = fieldIndex<T>(name); }
+
+    void scalar(JsonScalar& scalar) override {
+        if (field < 0) {
+            return;
+        }
+        visitField<T>(static_cast<size_t>(field), [&](const auto& descriptor) {
+            using F = std::remove_cvref_t<decltype(descriptor)>;
+            if constexpr (Scalar<typename F::Value>) {
+                typename F::Value value{};
+                if (descriptor.in(Json) && assignScalar(scalar, value)) {
+                    F::set(object, std::move(value));
+                }
+            }
+        });
+    }
+
+    std::unique_ptr<SaxSink> nested(bool array) override {
+        std::unique_ptr<SaxSink> sink;
+        if (field < 0) {
+            return sink;
+        }
+        visitField<T>(static_cast<size_t>(field), [&](const auto& descriptor) {
+            using F = std::remove_cvref_t<decltype(descriptor)>;
+            using V = typename F::Value;
+            if constexpr (!Scalar<V>) {
+                if (descriptor.in(Json)) {
+                    sink = makeSink<V>(array, [this](V&& value) { F::set(object, std::move(value)); });
+                }
+            }
+        });
+        return sink;
+    }
+
+    void close() override { done(std::move(object)); }
+};
+
+template <typename V>
+std::unique_ptr<SaxSink> makeSink(bool array, std::function<void(V&&)> done) {
+    if constexpr (List<V>) {
+        if (array) {
+            return std::make_unique<ArraySink<typename V::value_type>>(std::move(done));
+        }
+    } else if constexpr (Described<V>) {
+        if (!array) {
+            return std::make_unique<ObjectSink<V>>(std::move(done));
+        }
+    }
+    return nullptr;
+}
+
+// ---------- Двоичный снимок ----------
+
+// Запись модели делится на две части. Скалярные поля лежат в блоке
+// фиксированной ширины в порядке таблицы: bool - 1 байт, числа и перечисления -
+// свой размер, Date - int32 номер дня, время - int64 секунды, строки - uint32
+// номер в общей таблице строк (0 - пустая строка). Блоки всех записей секции
+// идут подряд, так что поле любой записи читается по известному смещению.
+//
+// Списки и вложенные модели записываются после блоков, в хвост секции переменной
+// длины: целые - zigzag-varint, списки - длиной и элементами, вложенные модели -
+// своими полями в порядке таблицы (с OmitDefault - после байта присутствия).
+class StringTable {
+private:
+    std::string bytes;
+    std::vector<uint32_t> offsets;
+    std::unordered_map<std::string_view, uint32_t> ids;
+
+public:
+    StringTable();
+
+    // Ключи ссылаются на переданные строки: они должны жить, пока строится снимок.
+    uint32_t add(const std::string& value);
+
+    const std::string& getBytes() const { return bytes; }
+    const std::vector<uint32_t>& getOffsets() const { return offsets; }
+    uint32_t size() const { return static_cast<uint32_t>(offsets.size() - 1); }
+};
+
+class BinaryWriter {
+private:
+    std::string& out;
+    StringTable& strings;
+
+public:
+    BinaryWriter(std::string& out, StringTable& strings) : out(out), strings(strings) {}
+
+    void unsignedVarint(uint64_t value);
+    void signedVarint(int64_t value);
+    void byte(uint8_t value) { out.push_back(static_cast<char>(value)); }
+    void string(const std::string& value) { unsignedVarint(strings.add(value)); }
+
+    template <typename I>
+    void fixed(I value) { out.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    void fixedString(const std::string& value) { fixed<uint32_t>(strings.add(value)); }
+};
+
+class BinaryReader {
+private:
+    const char* cursor;
+    const char* end;
+    const char* stringBytes;
+    uint64_t stringBytesSize;
+    const char* stringOffsets;
+    uint32_t stringCount;
+
+public:
+    BinaryReader(const char* begin, const char* end,
+                 const char* stringBytes, uint64_t stringBytesSize,
+                 const char* stringOffsets, uint32_t stringCount);
+
+    uint64_t unsignedVarint();
+    int64_t signedVarint();
+    uint8_t byte();
+    std::string string();
+    std::string_view stringView();
+    bool atEnd() const { return cursor == end; }
+
+    // Строка по номеру из блока фиксированной ширины.
+    std::string_view stringAt(uint64_t id) const;
+};
+
+template <typename V>
+consteval size_t fixedWidth() {
+    if constexpr (std::is_same_v<V, bool>) {
+        return 1;
+    } else if constexpr (std::is_enum_v<V> || std::is_arithmetic_v<V>) {
+        return sizeof(V);
+    } else if constexpr (std::is_same_v<V, TimePoint>) {
+        return sizeof(int64_t);
+    } else if constexpr (std::is_same_v<V, Date>) {
+        return sizeof(int32_t);
+    } else {
+        return sizeof(uint32_t);
+    }
+}
+
+// Размер блока фиксированной ширины одной записи T.
+template <Described T>
+consteval size_t fixedRecordSize() {
+    size_t size = 0;
+    forEachField<T>([&size](const auto& field) {
+        using V = typename std::remove_cvref_t<decltype(field)>::Value;
+        if constexpr (Scalar<V>) {
+            if (field.in(Binary)) {
+                size += fixedWidth<V>();
+            }
+        }
+    });
+    return size;
+}
+
+template <typename V>
+void writeFixedValue(BinaryWriter& writer, const V& value) {
+    if constexpr (std::is_same_v<V, bool>) {
+        writer.fixed<uint8_t>(value ? 1 : 0);
+    } else if constexpr (std::is_enum_v<V> || std::is_arithmetic_v<V>) {
+        writer.fixed(value);
+    } else if constexpr (std::is_same_v<V, TimePoint>) {
+        writer.fixed<int64_t>(static_cast<int64_t>(std::chrono::system_clock::to_time_t(value)));
+    } else if constexpr (std::is_same_v<V, Date>) {
+        writer.fixed<int32_t>(value.days());
+    } else if constexpr (std::is_same_v<V, Symbol>) {
+        writer.fixedString(value.str());
+    } else {
+        writer.fixedString(value);
+    }
+}
+
+template <typename V>
+void readFixedValue(const char* data, const BinaryReader& strings, V& value) {
+    if constexpr (std::is_same_v<V, bool>) {
+        value = *data != 0;
+    } else if constexpr (std::is_enum_v<V> || std::is_arithmetic_v<V>) {
+        std::memcpy(&value, data, sizeof(value));
+    } else if constexpr (std::is_same_v<V, TimePoint>) {
+        int64_t seconds = 0;
+        std::memcpy(&seconds, data, sizeof(seconds));
+        value = std::chrono::system_clock::from_time_t(static_cast<std::time_t>(seconds));
+    } else if constexpr (std::is_same_v<V, Date>) {
+        int32_t days = 0;
+        std::memcpy(&days, data, sizeof(days));
+        value = Date(days);
+    } else {
+        uint32_t id = 0;
+        std::memcpy(&id, data, sizeof(id));
+        if constexpr (std::is_same_v<V, Symbol>) {
+            value = Symbol(strings.stringAt(id));
+        } else {
+            value = std::string(strings.stringAt(id));
+        }
+    }
+}
+
+template <Described T>
+void writeBinary(BinaryWriter& writer, const T& object);
+
+template <Described T>
+void readBinary(BinaryReader& reader, T& object);
+
+template <typename V>
+void writeBinaryValue(BinaryWriter& writer, const V& value) {
+    if constexpr (Described<V>) {
+        writeBinary(writer, value);
+    } else if constexpr (List<V>) {
+        writer.unsignedVarint(value.size());
+        for (const auto& element : value) {
+            writeBinaryValue(writer, element);
+        }
+    } else if constexpr (std::is_same_v<V, bool>) {
+        writer.byte(value ? 1 : 0);
+    } else if constexpr (std::is_enum_v<V> || std::is_integral_v<V>) {
+        writer.signedVarint(static_cast<int64_t>(value));
+    } else if constexpr (std::is_same_v<V, TimePoint>) {
+        writer.signedVarint(static_cast<int64_t>(std::chrono::system_clock::to_time_t(value)));
+    } else if constexpr (std::is_same_v<V, Date>) {
+        writer.signedVarint(value.days());
+    } else if constexpr (std::is_same_v<V, Symbol>) {
+        writer.string(value.str());
+    } else {
+        static_assert(std::is_same_v<V, std::string>, "тип поля не поддерживается двоичным снимком");
+        writer.string(value);
+    }
+}
+
+template <typename V>
+void readBinaryValue(BinaryReader& reader, V& value) {
+    if constexpr (Described<V>) {
+        readBinary(reader, value);
+    } else if constexpr (List<V>) {
+        uint64_t count = reader.unsignedVarint();
+        value.clear();
+        for (uint64_t i = 0; i < count; ++i) {
+            typename V::value_type element{};
+            readBinaryValue(reader, element);
+            value.push_back(std::move(element));
+        }
+    } else if constexpr (std::is_same_v<V, bool>) {
+        value = reader.byte() != 0;
+    } else if constexpr (std::is_enum_v<V> || std::is_integral_v<V>) {
+        value = static_cast<V>(reader.signedVarint());
+    } else if constexpr (std::is_same_v<V, TimePoint>) {
+        value = std::chrono::system_clock::from_time_t(static_cast<std::time_t>(reader.signedVarint()));
+    } else if constexpr (std::is_same_v<V, Date>) {
+        value = Date(static_cast<int32_t>(reader.signedVarint()));
+    } else if constexpr (std::is_same_v<V, Symbol>) {
+        value = Symbol(reader.stringView());
+    } else {
+        value = reader.string();
+    }
+}
+
+template <Described T>
+void writeBinary(BinaryWriter& writer, const T& object) {
+    forEachField<T>([&](const auto& field) {
+        using V = typename std::remove_cvref_t<decltype(field)>::Value;
+        if (!field.in(Binary)) {
+            return;
+        }
+        const auto& value = field.get(object);
+        if constexpr (Described<V>) {
+            if (field.in(OmitDefault)) {
+                bool present = !isDefault(field, value);
+                writer.byte(present ? 1 : 0);
+                if (!present) {
+                    return;
+                }
+            }
+        }
+        writeBinaryValue(writer, value);
+    });
+}
+
+template <Described T>
+void readBinary(BinaryReader& reader, T& object) {
+    forEachField<T>([&](const auto& field) {
+        using F = std::remove_cvref_t<decltype(field)>;
+        using V = typename F::Value;
+        if (!field.in(Binary)) {
+            return;
+        }
+        if constexpr (Described<V>) {
+            if (field.in(OmitDefault) && reader.byte() == 0) {
+                return;
+            }
+        }
+        V value{};
+        readBinaryValue(reader, value);
+        F::set(object, std::move(value));
+    });
+}
+
+// Запись верхнего уровня: скалярные поля - в блок fixed, остальные - в хвост tail.
+template <Described T>
+void writeRecord(BinaryWriter& fixed, BinaryWriter& tail, const T& object) {
+    forEachField<T>([&](const auto& field) {
+        using V = typename std::remove_cvref_t<decltype(field)>::Value;
+        if (!field.in(Binary)) {
+            return;
+        }
+        const auto& value = field.get(object);
+        if constexpr (Scalar<V>) {
+            writeFixedValue(fixed, value);
+        } else {
+            if constexpr (Described<V>) {
+                if (field.in(OmitDefault)) {
+                    bool present = !isDefault(field, value);
+                    tail.byte(present ? 1 : 0);
+                    if (!present) {
+                        return;
+                    }
+                }
+            }
+            writeBinaryValue(tail, value);
+        }
+    });
+}
+
+// fixed указывает на блок записи (fixedRecordSize<T>() байт), tail читает хвост секции.
+template <Described T>
+void readRecord(const char* fixed, BinaryReader& tail, T& object) {
+    forEachField<T>([&](const auto& field) {
+        using F = std::remove_cvref_t<decltype(field)>;
+        using V = typename F::Value;
+        if (!field.in(Binary)) {
+            return;
+        }
+        V value{};
+        if constexpr (Scalar<V>) {
+            readFixedValue(fixed, tail, value);
+            fixed += fixedWidth<V>();
+        } else {
+            if constexpr (Described<V>) {
+                if (field.in(OmitDefault) && tail.byte() == 0) {
+                    return;
+                }
+            }
+            readBinaryValue(tail, value);
+        }
+        F::set(object, std::move(value));
+    });
+}
+
+// ---------- CSV ----------
+
+// Вложенные модели разворачиваются в отдельные столбцы, списки записываются
+// в одну ячейку через ';' (символы ';' и '\' внутри элементов экранируются).
+std::string joinList(const std::vector<std::string>& values);
+std::vector<std::string> splitList(const std::string& text);
+bool parseInteger(const std::string& text, int64_t& value);
+
+template <typename V>
+std::string toText(const V& value) {
+    if constexpr (List<V>) {
+        std::vector<std::string> items;
+        items.reserve(value.size());
+        for (const auto& element : value) {
+            items.push_back(toText(element));
+        }
+        return joinList(items);
+    } else if constexpr (std::is_same_v<V, bool>) {
+        return value ? "1" : "0";
+    } else if constexpr (std::is_enum_v<V> || std::is_integral_v<V>) {
+        return std::to_string(static_cast<int64_t>(value));
+    } else if constexpr (std::is_same_v<V, TimePoint>) {
+        return formatTime(value);
+    } else if constexpr (std::is_same_v<V, Date>) {
+        return value.toString();
+    } else if constexpr (std::is_same_v<V, Symbol>) {
+        return value.str();
+    } else {
+        return value;
+    }
+}
+
+template <typename V>
+bool fromText(const std::string& text, V& value) {
+    if constexpr (List<V>) {
+        value.clear();
+        for (const auto& item : splitList(text)) {
+            typename V::value_type element{};
+            if (fromText(item, element)) {
+                value.push_back(std::move(element));
+            }
+        }
+        return true;
+    } else if constexpr (std::is_same_v<V, bool>) {
+        value = text == "1" || text == "true";
+        return true;
+    } else if constexpr (std::is_enum_v<V> || std::is_integral_v<V>) {
+        int64_t number = 0;
+        if (!parseInteger(text, number)) {
+            return false;
+        }
+        value = static_cast<V>(number);
+        return true;
+    } else if constexpr (std::is_same_v<V, TimePoint>) {
+        value = parseTime(text);
+        return true;
+    } else if constexpr (std::is_same_v<V, Date>) {
+        value = Date::parse(text).value_or(Date());
+        return true;
+    } else if constexpr (std::is_same_v<V, Symbol>) {
+        value = Symbol(text);
+        return true;
+    } else {
+        value = text;
+        return true;
+    }
+}
+
+template <Described T>
+void csvHeader(std::vector<std::string>& labels) {
+    forEachField<T>([&](const auto& field) {
+        using V = typename std::remove_cvref_t<decltype(field)>::Value;
+        if (!field.in(Csv)) {
+            return;
+        }
+        if constexpr (Described<V>) {
+            csvHeader<V>(labels);
+        } else if constexpr (CellValue<V>) {
+            labels.emplace_back(field.label);
+        }
+    });
+}
+
+template <Described T>
+void csvRow(const T& object, std::vector<std::string>& cells) {
+    forEachField<T>([&](const auto& field) {
+        using V = typename std::remove_cvref_t<decltype(field)>::Value;
+        if (!field.in(Csv)) {
+            return;
+        }
+        if constexpr (Described<V>) {
+            csvRow(field.get(object), cells);
+        } else if constexpr (CellValue<V>) {
+            cells.push_back(toText(field.get(object)));
+        }
+    });
+}
+
+template <Described T>
+void csvAssign(T& object, const std::unordered_map<std::string, size_t>& columns,
+               const std::vector<std::string>& cells) {
+    forEachField<T>([&](const auto& field) {
+        using F = std::remove_cvref_t<decltype(field)>;
+        using V = typename F::Value;
+        if (!field.in(Csv)) {
+            return;
+        }
+        if constexpr (Described<V>) {
+            V nested = field.get(object);
+            csvAssign(nested, columns, cells);
+            F::set(object, std::move(nested));
+        } else if constexpr (CellValue<V>) {
+            auto it = columns.find(std::string(field.label));
+            if (it == columns.end() || it->second >= cells.size()) {
+                return;
+            }
+            V value{};
+            if (fromText(cells[it->second], value)) {
+                F::set(object, std::move(value));
+            }
+        }
+    });
+}
+
+}
@@ -3,7 +3,14 @@
 #include <vector>
 #include <functional>
 #include <map>
+#include <optional>
 #include "../models/task.h"
+#include "../models/task_store.h"
+#include "../models/task_selection.h"
+#include "../models/sort_spec.h"
+#include "../models/search_index.h"
+#include "regex_matcher.h"
+#include "../models/case_folding.h"
 
 class SearchService {
 public:
@@ -34,6 +41,46 @@ public:
             sortAscending(true) {}
     };
 
+    // Запрос, подготовленный один раз для проверки многих задач.
+    struct PreparedQuery {
+        std::string text;
+        std::string folded;
+        // Слова для matchWholeWord; в нижнем регистре, если регистр не учитывается.
+        std::vector<std::string> words;
+        // Скомпилированный text при useRegex, nullptr для некорректного выражения.
+        std::shared_ptr<RegexMatcher> pattern;
+        SearchOptions options;
+
+        // Сравнение идет по сложенному тексту; регулярное выражение через ДКА тоже,
+        // а запасной std::regex сам учитывает регистр по исходному.
+        bool foldsText() const {
+            return !options.caseSensitive && !(options.useRegex && pattern && !pattern->usesDfa());
+        }
+    };
+
+    // Место в упорядоченных результатах: копия последней показанной задачи,
+    // по ее ключам сортировки и ID. Следующая страница начинается сразу после
+    // нее, даже если задачи между запросами добавлялись или удалялись.
+    struct PageCursor {
+        Task last;
+    };
+
+    // limit задач после пропуска offset; при заданном after отсчет идет от курсора.
+    struct PageRequest {
+        size_t offset = 0;
+        size_t limit = 20;
+        std::optional<PageCursor> after;
+    };
+
+    struct SearchPage {
+        TaskSelection tasks;
+        size_t totalMatches = 0;
+        // Номер первой задачи страницы среди всех совпадений, с нуля.
+        size_t firstPosition = 0;
+        // Курсор следующей страницы; nullopt, если это последняя.
+        std::optional<PageCursor> next;
+    };
+
     struct TasksStatistics {
         int totalTasks = 0;
         int completedTasks = 0;
@@ -45,12 +92,48 @@ public:
         std::map<std::string, int> categoryStats;
     };
 
-    static std::vector<Task> search(
+    // Результаты - номера задач в tasks (или в хранилище) без копирования;
+    // действительны, пока задачи не изменились.
+    static TaskSelection search(
         const std::vector<Task>& tasks,
         const std::string& query,
         const SearchOptions& options = SearchOptions());
 
-    static std::vector<Task> advancedSearch(const std::vector<Task>& tasks, const SearchCriteria& criteria);
+    // То же по хранилищу: проверяются только кандидаты из индекса. Для
+    // регулярного выражения кандидаты отбираются по его обязательным
+    // фрагментам; если таких нет, просматриваются все задачи.
+    static TaskSelection search(
+        const TaskStore& store,
+        const SearchIndex& index,
+        const std::string& query,
+        const SearchOptions& options = SearchOptions());
+
+    // Совпадения в порядке хранения, без сортировки.
+    static TaskSelection findMatches(
+        const TaskStore& store,
+        const SearchIndex& index,
+        const std::string& query,
+        const SearchOptions& options = SearchOptions());
+
+    // Одна страница результатов search: сортируются только offset + limit
+    // первых совпадений (std::partial_sort), а не все. Порядок полный - при
+    // равных ключах options.sortField по ID, поэтому страницы не пересекаются.
+    static SearchPage searchPage(
+        const TaskStore& store,
+        const SearchIndex& index,
+        const std::string& query,
+        const SearchOptions& options,
+        const PageRequest& page);
+
+    // Задачи, удовлетворяющие всем заданным условиям, в исходном порядке.
+    // Условия проверяются от самых дешевых и избирательных к дорогим; доля
+    // подходящих задач для каждого условия оценивается по выборке.
+    static TaskSelection advancedSearch(const std::vector<Task>& tasks, const SearchCriteria& criteria);
+    // То же по хранилищу: условия по тегу и ключевому слову сначала сужают
+    // набор кандидатов по индексу, остальные проверяются по столбцам, и
+    // только затем задачи-кандидаты проверяются целиком.
+    static TaskSelection advancedSearch(const TaskStore& store, const SearchIndex& index,
+                                        const SearchCriteria& criteria);
 
     static void saveSearchCriteria(const SearchCriteria& criteria,
                                    std::map<std::string, SearchCriteria>& savedSearches);
@@ -58,24 +141,28 @@ public:
     static bool deleteSearchCriteria(const std::string& name,
                                      std::map<std::string, SearchCriteria>& savedSearches);
 
-    static std::vector<Task> applyFilter(const std::vector<Task>& tasks,
-                                         const std::function<bool(const Task&)>& predicate);
-
+    static PreparedQuery prepareQuery(const std::string& query, const SearchOptions& options);
+    static bool matchesQuery(const Task& task, const PreparedQuery& query);
+    // По сложенным копиям из хранилища; перед этим нужен TaskStore::prepareFolded().
+    static bool matchesQuery(const TaskStore::View& task, const PreparedQuery& query);
+    // description и notes - исходные или сложенные, как требует query.foldsText().
+    static bool matchesFields(const Task& task, std::string_view description, std::string_view notes,
+                              const PreparedQuery& query);
+    // Вхождение word, ограниченное с обеих сторон не словесными символами.
+    static bool containsWord(std::string_view text, std::string_view word);
+    // Фрагменты, которые входят в любое совпадение регулярного выражения
+    // (ECMAScript). Пусто, если выражение содержит альтернативу верхнего уровня
+    // или состоит только из классов, групп и необязательных символов.
+    static std::vector<std::string> regexLiterals(const std::string& pattern);
     static bool caseAwareContains(const std::string& haystack, const std::string& needle, bool caseSensitive);
     static bool matchWholeWord(const std::string& text, const std::string& word, bool caseSensitive);
     static std::string toLowerCase(const std::string& text);
     static std::vector<std::string> splitIntoWords(const std::string& text);
+    // field - одно поле или список ключей SortSpec ("priority desc, dueDate");
+    // ascending - направление ключей без явного asc/desc. Неизвестное поле - по ID.
     static void sortTasks(std::vector<Task>& tasks, const std::string& field, bool ascending);
-
-    static std::vector<Task> searchByKeyword(const std::vector<Task>& tasks, const std::string& keyword);
-    static std::vector<Task> searchByDateRange(const std::vector<Task>& tasks, const std::string& startDate, const std::string& endDate);
-    static std::vector<Task> searchTasksForToday(const std::vector<Task>& tasks);
-    static std::vector<Task> searchTasksForWeek(const std::vector<Task>& tasks);
-    static std::vector<Task> searchTasksForMonth(const std::vector<Task>& tasks);
-    static std::vector<Task> searchOverdueTasks(const std::vector<Task>& tasks);
-    static std::vector<Task> searchTasksBySubtaskCount(const std::vector<Task>& tasks, int minCount, int maxCount);
-    static std::vector<Task> searchTasksByDaysRemaining(const std::vector<Task>& tasks, int minDays, int maxDays);
-    static std::vector<Task> searchTasksWithIncompleteSubtasks(const std::vector<Task>& tasks);
+    static void sortTasks(TaskSelection& tasks, const std::string& field, bool ascending);
+    static SortSpec sortSpecOf(const std::string& field, bool ascending);
 
     static std::vector<std::string> getUniqueCategories(const std::vector<Task>& tasks);
     static std::vector<std::string> getUniqueTags(const std::vector<Task>& tasks);
@@ -0,0 +1,45 @@
+#pragma once
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+#include <cstdint>
+
+// Фоновая запись снимков. Новая задача заменяет еще не начатую, поэтому серия
+// быстрых сохранений приводит к одной записи на диск.
+class SnapshotWriter {
+public:
+    using Job = std::function<bool()>;
+    using DurableCallback = std::function<void(int64_t)>;
+
+    SnapshotWriter();
+    ~SnapshotWriter();
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    void submit(int64_t sequence, Job job);
+    void flush();
+    void setDurableCallback(DurableCallback callback);
+
+    int64_t getDurableSequence() const;
+
+private:
+    struct PendingJob {
+        int64_t sequence;
+        Job job;
+    };
+
+    void run();
+
+    mutable std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable workFinished;
+    std::optional<PendingJob> pending;
+    DurableCallback onDurable;
+    int64_t durableSequence;
+    bool busy;
+    bool stopping;
+    std::thread worker;
+};
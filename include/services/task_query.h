@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../models/task.h"
+#include "../models/task_store.h"
+#include "search_service.h"
+
+// Запрос к задачам на небольшом языке фильтров, например
+//
+//     tag:work prio>=3 due<2026-11-01 !done group:"Q4" text:"отчёт"
+//
+// Условия через пробел (или and/&) объединяются по И, or/| - по ИЛИ, !/not
+// и '-' отрицают, скобки группируют. Поля:
+//     tag:, cat:/category:, group: - точное совпадение;
+//     text: или слово без поля   - подстрока без учета регистра, как в поиске;
+//     prio/priority, id          - число, операторы : = != < <= > >=;
+//     due                         - ГГГГ-ММ-ДД, today или none, те же операторы;
+//     done                        - выполнена (done:yes / done:no).
+//
+// Текст разбирается один раз в плоскую программу: инструкции проверок
+// записывают результат в один регистр, а И и ИЛИ - условные переходы,
+// поэтому вычисление сокращенное и не требует стека. Значения тегов,
+// категорий и групп переводятся в символы при компиляции; программу нужно
+// компилировать заново, если запрос должен видеть значения, появившиеся позже.
+class TaskQuery {
+private:
+    enum class Op : uint8_t {
+        Priority, Id, Due, Completed, Category, Group, Tag, Text,
+        Constant, Not, JumpIfFalse, JumpIfTrue
+    };
+    // Набор допустимых исходов сравнения: бит 4 - меньше, 2 - равно, 1 - больше.
+    enum class Compare : uint8_t {
+        Equal = 2, NotEqual = 5, Less = 4, LessEqual = 6, Greater = 1, GreaterEqual = 3
+    };
+
+    struct Instruction {
+        Op op;
+        Compare compare = Compare::Equal;
+        int32_t value = 0;
+    };
+
+    std::vector<Instruction> program;
+    std::vector<SearchService::PreparedQuery> texts;
+
+    class Parser;
+
+    static bool compare(int32_t left, Compare compare, int32_t right) {
+        unsigned outcome = left < right ? 4u : (left == right ? 2u : 1u);
+        return (static_cast<unsigned>(compare) & outcome) != 0;
+    }
+
+    template <typename Row>
+    bool run(const Row& task) const;
+
+public:
+    // nullopt и описание ошибки в error, если запрос некорректен.
+    static std::optional<TaskQuery> compile(std::string_view text, std::string* error = nullptr);
+
+    bool matches(const Task& task) const;
+    // Перед проверкой условий text: по хранилищу нужен TaskStore::prepareFolded().
+    bool matches(const TaskStore::View& task) const;
+    bool usesText() const { return !texts.empty(); }
+
+    // Подходящие задачи хранилища в порядке хранения.
+    TaskSelection select(const TaskStore& store) const;
+};
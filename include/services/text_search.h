@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Поиск подстроки для просмотров без индекса. На x86 блоки текста по 16
+// (SSE2) или 32 (AVX2) байта сравниваются сразу с первым и последним
+// байтами образца, и только позиции, где совпали оба, проверяются целиком.
+// Вариант выбирается один раз при первом вызове по возможностям процессора;
+// на других платформах и для коротких хвостов используется std::string_view::find.
+class TextSearch {
+public:
+    static constexpr size_t npos = std::string_view::npos;
+
+    static size_t find(std::string_view haystack, std::string_view needle, size_t from = 0);
+    static bool contains(std::string_view haystack, std::string_view needle) {
+        return find(haystack, needle) != npos;
+    }
+
+    // "avx2", "sse2" или "scalar".
+    static const char* implementation();
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include <iostream>
 #include "../models/task.h"
+#include "../models/task_store.h"
 #include "../../include/models/reminder.h"
 
 class TaskView {
@@ -11,10 +12,15 @@ private:
     static std::string ERROR_COLOR;
     static std::string RESET_COLOR;
 
+    static void displayTaskTable(const TaskSelection& tasks);
+
 public:
     static void displayTask(const Task& task);
     static void displayTaskList(const std::vector<Task>& tasks);
-    static void displayTaskDetails(const Task& task);
+    static void displayTaskList(const TaskSelection& tasks);
+    // Страница результатов: first - номер первой задачи страницы, total - всего найдено.
+    static void displayTaskPage(const TaskSelection& page, size_t first, size_t total);
+    static void displayTaskDetails(const Task& task, const TaskStore& store);
     static void displaySubtasks(const std::vector<Task>& subtasks);
     static void displayReminders(const std::vector<Reminder>& reminders);
     static void displaySuccess(const std::string& message);
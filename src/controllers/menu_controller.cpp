@@ -186,7 +186,7 @@ void MenuController::remindersMenu() {
                 ss >> std::get_time(&tm, "%Y-%m-%d %H:%M");
 
                 Reminder reminder(taskId, message, std::chrono::system_clock::from_time_t(std::mktime(&tm)));
-                taskController.addReminder(reminder);
+                taskController.addReminder(std::move(reminder));
                 TaskView::displaySuccess("Напоминание добавлено.");
             }
             break;
@@ -219,7 +219,7 @@ void MenuController::filterSortMenu() {
         MenuView::displayFilterSortMenu();
         choice = MenuView::getUserChoice();
 
-        std::vector<Task> filteredTasks;
+        TaskSelection filteredTasks;
 
         switch (choice) {
             case 1: {
@@ -259,8 +259,19 @@ void MenuController::filterSortMenu() {
             break;
             case 6: {
                 std::string keyword = InputController::getInputString("Введите ключевое слово: ", false);
-                filteredTasks = taskController.searchTasks(keyword);
-                TaskView::displayTaskList(filteredTasks);
+                SearchService::PageRequest page;
+                while (true) {
+                    auto result = taskController.searchPage(keyword, SearchService::SearchOptions(), page);
+                    TaskView::displayTaskPage(result.tasks, result.firstPosition, result.totalMatches);
+                    if (!result.next) {
+                        break;
+                    }
+                    std::string answer = InputController::getInputString("Enter - следующая страница, 0 - назад: ");
+                    if (answer == "0") {
+                        break;
+                    }
+                    page.after = std::move(result.next);
+                }
             }
             break;
             case 7:
@@ -275,6 +286,53 @@ void MenuController::filterSortMenu() {
                 taskController.sortByCategory();
                 TaskView::displaySuccess("Задачи отсортированы по категории.");
                 break;
+            case 10: {
+                SearchService::SearchCriteria criteria;
+                criteria.keyword = InputController::getInputString("Ключевое слово (Enter - любое): ");
+                criteria.category = InputController::getInputString("Категория (Enter - любая): ");
+                criteria.tag = InputController::getInputString("Тег (Enter - любой): ");
+                criteria.projectGroup = InputController::getInputString("Группа проекта (Enter - любая): ");
+                criteria.dueDate = InputController::getInputString("Дата (YYYY-MM-DD, Enter - любая): ");
+                if (!criteria.dueDate.empty() && !InputController::validateDate(criteria.dueDate)) {
+                    TaskView::displayError("Некорректный формат даты.");
+                    break;
+                }
+                criteria.priority = InputController::getInputNumberWithDefault(
+                    "Приоритет (1-5, 0 - любой)", 0, 0, 5);
+                int status = InputController::getInputNumberWithDefault(
+                    "Статус (1 - выполненные, 2 - невыполненные, 0 - любые)", 0, 0, 2);
+                criteria.completedOnly = status == 1;
+                criteria.incompleteOnly = status == 2;
+                filteredTasks = taskController.advancedSearch(criteria);
+                TaskView::displayTaskList(filteredTasks);
+            }
+            break;
+            case 11: {
+                std::cout << "Пример: tag:work prio>=3 due<2026-11-01 !done group:\"Q4\" text:\"отчёт\"\n";
+                std::string text = InputController::getInputString("Запрос: ", false);
+                std::string error;
+                auto query = TaskQuery::compile(text, &error);
+                if (!query) {
+                    TaskView::displayError("Ошибка в запросе: " + error);
+                    break;
+                }
+                filteredTasks = taskController.selectTasks(*query);
+                TaskView::displayTaskList(filteredTasks);
+            }
+            break;
+            case 12: {
+                std::cout << "Поля: dueDate, priority, category, description, id, completed\n";
+                std::string text = InputController::getInputString("Порядок (например: priority desc, dueDate asc): ", false);
+                std::string error;
+                auto spec = SortSpec::parse(text, true, &error);
+                if (!spec) {
+                    TaskView::displayError("Ошибка в порядке сортировки: " + error);
+                    break;
+                }
+                taskController.sortBy(*spec);
+                TaskView::displaySuccess("Задачи отсортированы: " + spec->toString() + ".");
+            }
+            break;
             case 0:
                 break;
             default:
@@ -298,16 +356,16 @@ void MenuController::exportMenu() {
 
         switch (choice) {
             case 1:
-                success = ExportService::exportToMarkdown(taskController.getAllTasks(), filename);
+                success = ExportService::exportToMarkdown(taskController.getTaskStore(), filename);
                 break;
             case 2:
-                success = ExportService::exportToCSV(taskController.getAllTasks(), filename);
+                success = ExportService::exportToCSV(taskController.getTaskStore(), filename);
                 break;
             case 3:
-                success = ExportService::exportToICS(taskController.getAllTasks(), filename);
+                success = ExportService::exportToICS(taskController.getTaskStore(), filename);
                 break;
             case 4:
-                success = ExportService::exportToHTML(taskController.getAllTasks(), filename);
+                success = ExportService::exportToHTML(taskController.getTaskStore(), filename);
                 break;
             case 5: {
                 filename = InputController::getInputString("Введите имя файла: ", false);
@@ -320,6 +378,9 @@ void MenuController::exportMenu() {
                 success = ExportService::importTemplates(filename, templates);
             }
             break;
+            case 7:
+                success = taskController.saveToJson();
+                break;
             case 0:
                 break;
             default:
@@ -514,7 +575,7 @@ void MenuController::addTaskMenu() {
     std::string projectGroup = InputController::getInputString("Введите группу проекта: ", true);
     newTask.setProjectGroup(projectGroup);
 
-    int taskId = taskController.addTask(newTask);
+    int taskId = taskController.addTask(std::move(newTask));
     if (taskId != -1) {
         TaskView::displaySuccess("Задача создана с ID: " + std::to_string(taskId));
         Logger::getInstance().info("Создана новая задача с ID: " + std::to_string(taskId));
@@ -588,23 +649,10 @@ void MenuController::editTemplateMenu() {
             }
         }
 
-        TaskTemplate cleanTemplate;
-        cleanTemplate.setName(updatedTemplate.getName());
-        cleanTemplate.setDescription(updatedTemplate.getDescription());
-        cleanTemplate.setCategory(updatedTemplate.getCategory());
-        cleanTemplate.setPriority(updatedTemplate.getPriority());
-        cleanTemplate.setRecurrence(updatedTemplate.getRecurrence());
-        cleanTemplate.setNotes(updatedTemplate.getNotes());
-        cleanTemplate.setProjectGroup(updatedTemplate.getProjectGroup());
-        cleanTemplate.setTags(updatedTemplate.getTags());
-
-        for (const auto &desc: newSubtaskDescs) {
-            cleanTemplate.addSubtaskDescription(desc);
-        }
-        updatedTemplate = cleanTemplate;
+        updatedTemplate.setSubtaskDescriptions(std::move(newSubtaskDescs));
     }
 
-    bool success = taskController.updateTemplate(templateName, updatedTemplate);
+    bool success = taskController.updateTemplate(templateName, std::move(updatedTemplate));
     if (success) {
         TaskView::displaySuccess("Шаблон обновлен.");
     } else {
@@ -621,7 +669,7 @@ void MenuController::viewTaskDetailsMenu() {
         return;
     }
 
-    TaskView::displayTaskDetails(*task);
+    TaskView::displayTaskDetails(*task, taskController.getTaskStore());
 }
 
 void MenuController::addSubtaskMenu() {
@@ -655,7 +703,7 @@ void MenuController::addSubtaskMenu() {
     std::vector<std::string> tags = InputController::parseTags(tagString);
     newSubtask.setTags(tags);
 
-    int subtaskId = taskController.addSubtask(parentId, newSubtask);
+    int subtaskId = taskController.addSubtask(parentId, std::move(newSubtask));
     if (subtaskId != -1) {
         TaskView::displaySuccess("Подзадача создана с ID: " + std::to_string(subtaskId));
     } else {
@@ -674,7 +722,7 @@ void MenuController::editSubtaskMenu() {
         return;
     }
 
-    TaskView::displayTaskDetails(*subtask);
+    TaskView::displayTaskDetails(*subtask, taskController.getTaskStore());
 
     std::string description = InputController::getInputStringWithDefault(
         "Введите описание подзадачи", subtask->getDescription());
@@ -694,15 +742,15 @@ void MenuController::editSubtaskMenu() {
                                                                        InputController::joinTags(subtask->getTags()));
     std::vector<std::string> tags = InputController::parseTags(tagString);
 
-    Task updatedSubtask = *subtask;
-    updatedSubtask.setDescription(description);
-    updatedSubtask.setDueDate(dueDate);
-    updatedSubtask.setPriority(priority);
-    updatedSubtask.setCategory(category);
-    updatedSubtask.setNotes(notes);
-    updatedSubtask.setTags(tags);
+    Task values(std::move(description), dueDate);
+    values.setPriority(priority);
+    values.setCategory(category);
+    values.setNotes(std::move(notes));
+    values.setTags(tags);
 
-    bool success = taskController.editSubtask(subtaskId, updatedSubtask);
+    const unsigned mask = TaskFields::Description | TaskFields::DueDate | TaskFields::Priority |
+                          TaskFields::Category | TaskFields::Notes | TaskFields::Tags;
+    bool success = taskController.patchTask(subtaskId, mask, std::move(values));
     if (success) {
         TaskView::displaySuccess("Подзадача обновлена.");
     } else {
@@ -745,7 +793,7 @@ void MenuController::addTemplateMenu() {
         }
     }
 
-    taskController.addTemplate(newTemplate);
+    taskController.addTemplate(std::move(newTemplate));
     TaskView::displaySuccess("Шаблон создан: " + name);
 }
 
@@ -762,7 +810,7 @@ void MenuController::editTaskMenu() {
         return;
     }
 
-    TaskView::displayTaskDetails(*task);
+    TaskView::displayTaskDetails(*task, taskController.getTaskStore());
 
     std::string description = InputController::getInputStringWithDefault(
         "Введите описание задачи", task->getDescription());
@@ -787,17 +835,22 @@ void MenuController::editTaskMenu() {
     std::string projectGroup = InputController::getInputStringWithDefault(
         "Введите группу проекта", task->getProjectGroup());
 
-    Task updatedTask = *task;
-    updatedTask.setDescription(description);
-    updatedTask.setDueDate(dueDate);
-    updatedTask.setPriority(priority);
-    updatedTask.setCategory(category);
-    updatedTask.setNotes(notes);
-    updatedTask.setRecurrence(recurrence);
-    updatedTask.setTags(tags);
-    updatedTask.setProjectGroup(projectGroup);
-
-    bool success = taskController.editTask(taskId, updatedTask);
+    Task values(std::move(description), dueDate);
+    values.setPriority(priority);
+    values.setCategory(category);
+    values.setNotes(std::move(notes));
+    values.setTags(tags);
+    values.setProjectGroup(projectGroup);
+
+    unsigned mask = TaskFields::Description | TaskFields::DueDate | TaskFields::Priority | TaskFields::Category |
+                    TaskFields::Notes | TaskFields::Tags | TaskFields::ProjectGroup;
+    // Полное правило повторения меняется, только если пользователь выбрал другой тип.
+    if (recurrence != task->getRecurrence()) {
+        values.setRecurrence(recurrence);
+        mask |= TaskFields::Recurrence;
+    }
+
+    bool success = taskController.patchTask(taskId, mask, std::move(values));
     if (success) {
         TaskView::displaySuccess("Задача обновлена.");
     } else {
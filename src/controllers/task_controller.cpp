@@ -4,9 +4,13 @@
 #include <iostream>
 #include <chrono>
 #include <fstream>
+#include <filesystem>
 #include <sstream>
+#include <utility>
 #include <nlohmann/json.hpp>
 #include "../../include/services/logger.h"
+#include "../../include/services/clock.h"
+#include "../../include/services/text_search.h"
 #include "../../include/services/input_validator.h"
 
 using std::istringstream;
@@ -14,24 +18,40 @@ using std::get_time;
 using json = nlohmann::json;
 
 TaskController::TaskController(const std::string& dataFile)
-    : nextId(1), modified(false), dataFilePath(dataFile) {
+    : nextId(1), modified(false), dataFilePath(dataFile), segmentDirectory(dataFile + ".segments"),
+      journal(dataFile + ".journal"),
+      snapshotSequence(0), replayingJournal(false), checkpointGeneration(0) {
     Logger::getInstance().setLevel(LogLevel::INFO);
     Logger::getInstance().setLogFile("todolist.log");
     Logger::getInstance().info("Запуск приложения");
 
-    if (!loadFromJson()) {
+    if (!loadSnapshot()) {
         Logger::getInstance().warning("Не удалось загрузить данные из файла: " + dataFilePath);
     } else {
         Logger::getInstance().info("Данные успешно загружены из файла: " + dataFilePath);
     }
+
+    replayJournal();
+    journal.removeSegmentsUpTo(snapshotSequence);
+    snapshotWriter.setDurableCallback([this](int64_t sequence) {
+        journal.removeSegmentsUpTo(sequence);
+    });
 }
 
+// При завершении сохраняются только грязные сегменты и манифест: все изменения
+// уже в журнале, а tasks.json переписывается целиком лишь при явном экспорте.
 TaskController::~TaskController() {
-    if (modified) {
-        if (saveToJson()) {
-            Logger::getInstance().info("Данные успешно сохранены в файл: " + dataFilePath);
+    bool saving = modified;
+    if (saving) {
+        checkpoint();
+    }
+    snapshotWriter.flush();
+
+    if (saving) {
+        if (snapshotWriter.getDurableSequence() >= snapshotSequence) {
+            Logger::getInstance().info("Данные успешно сохранены в " + segmentDirectory);
         } else {
-            Logger::getInstance().error("Не удалось сохранить данные в файл: " + dataFilePath);
+            Logger::getInstance().error("Не удалось сохранить данные в " + segmentDirectory);
         }
     }
     Logger::getInstance().info("Завершение работы приложения");
@@ -43,56 +63,53 @@ int TaskController::addTask(Task task) {
         return -1;
     }
 
-    task.setId(nextId++);
-    tasks.push_back(task);
-    modified = true;
+    int id = nextId++;
+    task.setId(id);
+    task.setParentId(0);
+    journalTask(tasks.push_back(std::move(task)));
+
+    Logger::getInstance().info("Создана новая задача с ID: " + std::to_string(id));
+    return id;
+}
 
-    Logger::getInstance().info("Создана новая задача с ID: " + std::to_string(task.getId()));
-    return task.getId();
+bool TaskController::editTask(int taskId, Task updatedTask) {
+    return patchTask(taskId, TaskFields::All, std::move(updatedTask));
 }
 
-bool TaskController::editTask(int taskId, const Task& updatedTask) {
+bool TaskController::patchTask(int taskId, unsigned mask, Task values) {
     Task* task = findTaskById(taskId);
     if (!task) {
         Logger::getInstance().warning("Попытка редактировать несуществующую задачу с ID: " + std::to_string(taskId));
         return false;
     }
 
-    if (!InputValidator::isValidDate(updatedTask.getDueDate())) {
-        Logger::getInstance().warning("Попытка установить некорректную дату: " + updatedTask.getDueDate());
+    if ((mask & TaskFields::DueDate) && !InputValidator::isValidDate(values.getDueDate())) {
+        Logger::getInstance().warning("Попытка установить некорректную дату: " + values.getDueDate());
         return false;
     }
 
-    int id = task->getId();
-    std::vector<Task> subtasks = task->getSubtasks();
-
-    task->setDescription(updatedTask.getDescription());
-    task->setDueDate(updatedTask.getDueDate());
-    task->setPriority(updatedTask.getPriority());
-    task->setCategory(updatedTask.getCategory());
-    task->setRecurrence(updatedTask.getRecurrence());
-    task->setCompleted(updatedTask.isCompleted());
-    task->setNotes(updatedTask.getNotes());
-    task->setTags(updatedTask.getTags());
-    task->setProjectGroup(updatedTask.getProjectGroup());
-
-    modified = true;
+    task->patch(mask, std::move(values));
+    journalTask(*task);
     Logger::getInstance().info("Задача с ID: " + std::to_string(taskId) + " успешно обновлена");
     return true;
 }
 
 bool TaskController::deleteTask(int taskId) {
-    auto it = std::find_if(tasks.begin(), tasks.end(), 
-                          [taskId](const Task& t) { return t.getId() == taskId; });
-    
-    if (it == tasks.end()) {
+    int slot = tasks.slotOf(taskId);
+    if (slot == IdIndex::NOT_FOUND) {
         Logger::getInstance().warning("Попытка удалить несуществующую задачу с ID: " + std::to_string(taskId));
         return false;
     }
 
-    tasks.erase(it);
-    removeReminder(taskId);
-    modified = true;
+    std::vector<int> removedIds = tasks.erase(slot);
+    for (int removedId : removedIds) {
+        searchIndex.remove(removedId);
+        markTaskDirty(removedId);
+    }
+    journalRecord({{"op", "deleteTask"}, {"id", taskId}});
+    for (int removedId : removedIds) {
+        removeReminder(removedId);
+    }
     Logger::getInstance().info("Задача с ID: " + std::to_string(taskId) + " удалена");
     return true;
 }
@@ -105,92 +122,75 @@ bool TaskController::markTaskComplete(int taskId, bool completed) {
     }
 
     task->setCompleted(completed);
+    journalTask(*task);
 
     if (completed && task->getRecurrence() != Recurrence::None) {
         createRecurrentTaskCopy(taskId);
         Logger::getInstance().info("Создана повторяющаяся копия задачи с ID: " + std::to_string(taskId));
     }
 
-    modified = true;
     Logger::getInstance().info("Задача с ID: " + std::to_string(taskId) + " отмечена как " +
                               (completed ? "выполненная" : "невыполненная"));
     return true;
 }
 
-int TaskController::addSubtask(int parentId, const Task& subtask) {
-    Task* parentTask = findTaskById(parentId);
-    if (!parentTask) {
+int TaskController::addSubtask(int parentId, Task subtask) {
+    if (!findTaskById(parentId)) {
         return -1;
     }
     
-    Task newSubtask = subtask;
-    newSubtask.setId(nextId++);
-    
-    parentTask->addSubtask(newSubtask);
-    modified = true;
-    return newSubtask.getId();
+    int id = nextId++;
+    subtask.setId(id);
+    subtask.setParentId(parentId);
+    journalTask(tasks.push_back(std::move(subtask)));
+    return id;
 }
 
-bool TaskController::editSubtask(int subtaskId, const Task& updatedSubtask) {
-    Task* parentTask = nullptr;
-    Task* subtask = findSubtaskById(subtaskId, &parentTask);
-    
-    if (!subtask || !parentTask) {
+bool TaskController::editSubtask(int subtaskId, Task updatedSubtask) {
+    if (!findSubtaskById(subtaskId)) {
         return false;
     }
 
-    int id = subtask->getId();
-
-    subtask->setDescription(updatedSubtask.getDescription());
-    subtask->setDueDate(updatedSubtask.getDueDate());
-    subtask->setPriority(updatedSubtask.getPriority());
-    subtask->setCategory(updatedSubtask.getCategory());
-    subtask->setCompleted(updatedSubtask.isCompleted());
-    subtask->setNotes(updatedSubtask.getNotes());
-    subtask->setTags(updatedSubtask.getTags());
-    
-    modified = true;
-    return true;
+    const unsigned mask = TaskFields::Description | TaskFields::DueDate | TaskFields::Priority |
+                          TaskFields::Category | TaskFields::Completed | TaskFields::Notes | TaskFields::Tags;
+    return patchTask(subtaskId, mask, std::move(updatedSubtask));
 }
 
 bool TaskController::deleteSubtask(int subtaskId) {
-    Task* parentTask = nullptr;
-    Task* subtask = findSubtaskById(subtaskId, &parentTask);
-    
-    if (!subtask || !parentTask) {
+    if (!findSubtaskById(subtaskId)) {
         return false;
     }
-    
-    parentTask->removeSubtask(subtaskId);
-    modified = true;
-    return true;
+
+    return deleteTask(subtaskId);
 }
 
 bool TaskController::markSubtaskComplete(int subtaskId, bool completed) {
-    Task* parentTask = nullptr;
-    Task* subtask = findSubtaskById(subtaskId, &parentTask);
-    
-    if (!subtask || !parentTask) {
+    Task* subtask = findSubtaskById(subtaskId);
+    if (!subtask) {
         return false;
     }
     
     subtask->setCompleted(completed);
-    modified = true;
+    journalTask(*subtask);
     return true;
 }
 
-void TaskController::addTemplate(const TaskTemplate& templ) {
-    templates[templ.getName()] = templ;
-    modified = true;
+void TaskController::addTemplate(TaskTemplate templ) {
+    auto it = templates.try_emplace(templ.getName()).first;
+    it->second = std::move(templ);
+    markTemplateDirty(it->first);
+    journalRecord({{"op", "putTemplate"}, {"template", FileService::templateToJson(it->second)}});
 }
 
-bool TaskController::updateTemplate(const std::string& name, const TaskTemplate& updatedTemplate) {
-    if (templates.find(name) == templates.end()) {
+bool TaskController::updateTemplate(const std::string& name, TaskTemplate updatedTemplate) {
+    auto it = templates.find(name);
+    if (it == templates.end()) {
         return false;
     }
     
-    templates[name] = updatedTemplate;
-    modified = true;
+    it->second = std::move(updatedTemplate);
+    markTemplateDirty(name);
+    journalRecord({{"op", "putTemplate"}, {"template", FileService::templateToJson(it->second)}});
     return true;
 }
 
@@ -200,7 +200,8 @@ bool TaskController::deleteTemplate(const std::string& name) {
     }
     
     templates.erase(name);
-    modified = true;
+    markTemplateDirty(name);
+    journalRecord({{"op", "deleteTemplate"}, {"name", name}});
     return true;
 }
 
@@ -211,16 +212,23 @@ int TaskController::createTaskFromTemplate(const std::string& templateName, cons
     
     const TaskTemplate& templ = templates.at(templateName);
     Task newTask = templ.createTask(dueDate);
-    newTask.setId(nextId++);
-    
-    tasks.push_back(newTask);
-    modified = true;
-    return newTask.getId();
+    int id = nextId++;
+    newTask.setId(id);
+    std::vector<Task> subtasks = templ.createSubtasks(newTask);
+    journalTask(tasks.push_back(std::move(newTask)));
+
+    for (auto& subtask : subtasks) {
+        subtask.setId(nextId++);
+        subtask.setParentId(id);
+        journalTask(tasks.push_back(std::move(subtask)));
+    }
+    return id;
 }
 
-void TaskController::addReminder(const Reminder& reminder) {
-    reminders.push_back(reminder);
-    modified = true;
+void TaskController::addReminder(Reminder reminder) {
+    reminders.push_back(std::move(reminder));
+    markRemindersDirty();
+    journalRecord({{"op", "addReminder"}, {"reminder", FileService::reminderToJson(reminders.back())}});
 }
 
 bool TaskController::removeReminder(int taskId) {
@@ -231,13 +239,14 @@ bool TaskController::removeReminder(int taskId) {
     reminders.erase(it, reminders.end());
     
     if (found) {
-        modified = true;
+        markRemindersDirty();
+        journalRecord({{"op", "removeReminders"}, {"taskId", taskId}});
     }
     return found;
 }
 
 void TaskController::checkReminders() {
-    auto now = std::chrono::system_clock::now();
+    auto now = Clock::now();
     bool changed = false;
     
     for (auto& reminder : reminders) {
@@ -258,7 +267,12 @@ void TaskController::checkReminders() {
     }
     
     if (changed) {
-        modified = true;
+        json remindersJson = json::array();
+        for (const auto& reminder : reminders) {
+            remindersJson.push_back(FileService::reminderToJson(reminder));
+        }
+        markRemindersDirty();
+        journalRecord({{"op", "setReminders"}, {"reminders", remindersJson}});
     }
 }
 
@@ -270,7 +284,7 @@ void TaskController::addTaskToGroup(int taskId, const std::string& groupName) {
     
     task->setProjectGroup(groupName);
     projectGroups.insert(groupName);
-    modified = true;
+    journalTask(*task);
 }
 
 void TaskController::removeTaskFromGroup(int taskId) {
@@ -280,23 +294,28 @@ void TaskController::removeTaskFromGroup(int taskId) {
     }
     
     task->setProjectGroup("");
-    modified = true;
+    journalTask(*task);
 }
 
 bool TaskController::renameProjectGroup(const std::string& oldName, const std::string& newName) {
     if (projectGroups.find(oldName) == projectGroups.end()) {
         return false;
     }
-    
-    for (auto& task : tasks) {
-        if (task.getProjectGroup() == oldName) {
-            task.setProjectGroup(newName);
+
+    Symbol from(oldName);
+    Symbol to(newName);
+    const auto& groups = tasks.groupColumn();
+    for (size_t slot = 0; slot < tasks.size(); ++slot) {
+        if (groups[slot] == from.getId()) {
+            tasks.edit(slot).setProjectGroupSymbol(to);
+            tasks.refresh(slot);
+            markTaskDirty(tasks[slot].getId());
         }
     }
     
     projectGroups.erase(oldName);
     projectGroups.insert(newName);
-    modified = true;
+    journalRecord({{"op", "renameGroup"}, {"from", oldName}, {"to", newName}});
     return true;
 }
 
@@ -304,117 +323,144 @@ bool TaskController::deleteProjectGroup(const std::string& groupName) {
     if (projectGroups.find(groupName) == projectGroups.end()) {
         return false;
     }
-    
-    for (auto& task : tasks) {
-        if (task.getProjectGroup() == groupName) {
-            task.setProjectGroup("");
+
+    Symbol group(groupName);
+    const auto& groups = tasks.groupColumn();
+    for (size_t slot = 0; slot < tasks.size(); ++slot) {
+        if (groups[slot] == group.getId()) {
+            tasks.edit(slot).setProjectGroupSymbol(Symbol());
+            tasks.refresh(slot);
+            markTaskDirty(tasks[slot].getId());
         }
     }
     
     projectGroups.erase(groupName);
-    modified = true;
+    journalRecord({{"op", "deleteGroup"}, {"name", groupName}});
     return true;
 }
 
-std::vector<Task> TaskController::searchTasks(const std::string& keyword) const {
-    std::vector<Task> results;
-    
-    for (const auto& task : tasks) {
-        if (task.getDescription().find(keyword) != std::string::npos ||
-            task.getCategory().find(keyword) != std::string::npos ||
-            task.getNotes().find(keyword) != std::string::npos) {
-            results.push_back(task);
-        } else {
-            const auto& tags = task.getTags();
-            for (const auto& tag : tags) {
-                if (tag.find(keyword) != std::string::npos) {
-                    results.push_back(task);
-                    break;
-                }
+TaskSelection TaskController::searchTasks(const std::string& keyword) const {
+    auto matches = [&keyword](const Task& task) {
+        if (TextSearch::contains(task.getDescription(), keyword) ||
+            TextSearch::contains(task.getCategory(), keyword) ||
+            TextSearch::contains(task.getNotes(), keyword)) {
+            return true;
+        }
+        for (const auto& tag : task.getTags()) {
+            if (TextSearch::contains(tag, keyword)) {
+                return true;
             }
         }
+        return false;
+    };
+
+    auto candidates = getSearchIndex().substringCandidates(keyword);
+    if (!candidates) {
+        return tasks.select([&matches](const TaskStore::View& task) { return matches(task.task()); });
+    }
+
+    // Кандидаты упорядочены по ID, результат - в порядке хранения.
+    std::vector<int> slots;
+    slots.reserve(candidates->size());
+    for (int id : *candidates) {
+        int slot = tasks.slotOf(id);
+        if (slot != TaskStore::NO_SLOT) {
+            slots.push_back(slot);
+        }
     }
-    
-    return results;
-}
+    std::sort(slots.begin(), slots.end());
 
-std::vector<Task> TaskController::filterByCategory(const std::string& category) const {
-    std::vector<Task> results;
-    
-    for (const auto& task : tasks) {
-        if (task.getCategory() == category) {
-            results.push_back(task);
+    TaskSelection results(tasks.all());
+    for (int slot : slots) {
+        if (matches(tasks[slot])) {
+            results.add(slot);
         }
     }
-    
     return results;
 }
 
-std::vector<Task> TaskController::filterByStatus(bool completed) const {
-    std::vector<Task> results;
-    
-    for (const auto& task : tasks) {
-        if (task.isCompleted() == completed) {
-            results.push_back(task);
-        }
+SearchService::SearchPage TaskController::searchPage(const std::string& query,
+                                                     const SearchService::SearchOptions& options,
+                                                     const SearchService::PageRequest& page) const {
+    return SearchService::searchPage(tasks, getSearchIndex(), query, options, page);
+}
+
+const SearchIndex& TaskController::getSearchIndex() const {
+    if (!searchIndex.isReady()) {
+        searchIndex.build(tasks);
     }
-    
-    return results;
+    return searchIndex;
 }
 
-std::vector<Task> TaskController::filterByDueDate(const std::string& date) const {
-    std::vector<Task> results;
-    
-    for (const auto& task : tasks) {
-        if (task.getDueDate() == date) {
-            results.push_back(task);
-        }
+TaskSelection TaskController::advancedSearch(const SearchService::SearchCriteria& criteria) const {
+    return SearchService::advancedSearch(tasks, getSearchIndex(), criteria);
+}
+
+TaskSelection TaskController::selectTasks(const TaskQuery& query) const {
+    return query.select(tasks);
+}
+
+TaskSelection TaskController::filterByCategory(const std::string& category) const {
+    auto symbol = Symbol::lookup(category);
+    if (!symbol) {
+        return {};
     }
-    
-    return results;
+
+    uint32_t id = symbol->getId();
+    return tasks.select([id](const TaskStore::View& task) { return task.getCategoryId() == id; });
 }
 
-std::vector<Task> TaskController::filterByTag(const std::string& tag) const {
-    std::vector<Task> results;
-    
-    for (const auto& task : tasks) {
-        const auto& tags = task.getTags();
-        if (std::find(tags.begin(), tags.end(), tag) != tags.end()) {
-            results.push_back(task);
-        }
+TaskSelection TaskController::filterByStatus(bool completed) const {
+    return tasks.select([completed](const TaskStore::View& task) { return task.isCompleted() == completed; });
+}
+
+TaskSelection TaskController::filterByDueDate(const std::string& date) const {
+    auto parsed = Date::parse(date);
+    if (!parsed) {
+        return {};
     }
-    
-    return results;
+    Date day = *parsed;
+    return tasks.select([day](const TaskStore::View& task) { return task.getDue() == day; });
 }
 
-std::vector<Task> TaskController::filterByProjectGroup(const std::string& groupName) const {
-    std::vector<Task> results;
-    
-    for (const auto& task : tasks) {
-        if (task.getProjectGroup() == groupName) {
-            results.push_back(task);
-        }
+TaskSelection TaskController::filterByTag(const std::string& tag) const {
+    auto symbol = Symbol::lookup(tag);
+    if (!symbol) {
+        return {};
     }
-    
-    return results;
+
+    Symbol value = *symbol;
+    return tasks.select([value](const TaskStore::View& task) { return task.task().hasTag(value); });
+}
+
+TaskSelection TaskController::filterByProjectGroup(const std::string& groupName) const {
+    auto symbol = Symbol::lookup(groupName);
+    if (!symbol) {
+        return {};
+    }
+
+    uint32_t id = symbol->getId();
+    return tasks.select([id](const TaskStore::View& task) { return task.getProjectGroupId() == id; });
 }
 
 void TaskController::sortByPriority() {
-    std::sort(tasks.begin(), tasks.end(), 
-             [](const Task& a, const Task& b) { return a.getPriority() > b.getPriority(); });
-    modified = true;
+    tasks.sortBy(SortSpec({{SortSpec::Field::Priority, false}}));
+    journalRecord({{"op", "sort"}, {"by", "priority"}});
 }
 
 void TaskController::sortByDueDate() {
-    std::sort(tasks.begin(), tasks.end(), 
-             [](const Task& a, const Task& b) { return a.getDueDate() < b.getDueDate(); });
-    modified = true;
+    tasks.sortBy(SortSpec({{SortSpec::Field::Due, true}}));
+    journalRecord({{"op", "sort"}, {"by", "dueDate"}});
 }
 
 void TaskController::sortByCategory() {
-    std::sort(tasks.begin(), tasks.end(), 
-             [](const Task& a, const Task& b) { return a.getCategory() < b.getCategory(); });
-    modified = true;
+    tasks.sortBy(SortSpec({{SortSpec::Field::Category, true}}));
+    journalRecord({{"op", "sort"}, {"by", "category"}});
+}
+
+void TaskController::sortBy(const SortSpec& spec) {
+    tasks.sortBy(spec);
+    journalRecord({{"op", "sort"}, {"by", spec.toString()}});
 }
 
 void TaskController::createRecurrentTaskCopy(int taskId) {
@@ -426,322 +472,318 @@ void TaskController::createRecurrentTaskCopy(int taskId) {
     Task newTask = *task;
     newTask.setId(nextId++);
     newTask.setCompleted(false);
-    newTask.setDueDate(task->getNextOccurrenceDate());
+    newTask.setDue(task->getNextOccurrence());
+    journalTask(tasks.push_back(std::move(newTask)));
+}
+
+bool TaskController::loadSnapshot() {
+    const std::string manifestPath = segmentDirectory + "/manifest.bin";
+    if (FileService::fileExists(manifestPath)) {
+        bool segmentsAreCurrent = true;
+        if (FileService::fileExists(dataFilePath)) {
+            std::error_code error;
+            auto manifestTime = std::filesystem::last_write_time(manifestPath, error);
+            auto jsonTime = std::filesystem::last_write_time(dataFilePath, error);
+            segmentsAreCurrent = !error && manifestTime >= jsonTime;
+        }
 
-    std::vector<Task> emptySubtasks;
-    newTask.setSubtasks(emptySubtasks);
-    
-    tasks.push_back(newTask);
-    modified = true;
+        if (segmentsAreCurrent && loadFromSegments()) {
+            return true;
+        }
+    }
+
+    if (!loadFromJson()) {
+        return false;
+    }
+
+    markAllDirty();
+    return true;
+}
+
+bool TaskController::loadFromSegments() {
+    FileService::SegmentManifest manifest;
+    std::vector<Task> loadedTasks = tasks.release();
+    bool loaded = FileService::loadSegments(segmentDirectory, SEGMENT_SIZE, loadedTasks, reminders, templates,
+                                            projectGroups, nextId, manifest);
+    tasks.assign(std::move(loadedTasks));
+    searchIndex.clear();
+    if (!loaded) {
+        return false;
+    }
+
+    snapshotSequence = manifest.journalSequence;
+    segmentFiles = manifest.segments;
+    return true;
 }
 
 bool TaskController::loadFromJson() {
-    std::ifstream file(dataFilePath);
-    if (!file.is_open()) {
+    if (!FileService::fileExists(dataFilePath)) {
         return false;
     }
-    
-    try {
-        json jsonData;
-        file >> jsonData;
-        
-        tasks.clear();
-        reminders.clear();
-        templates.clear();
-        projectGroups.clear();
-        nextId = 1;
-
-        if (jsonData.contains("tasks") && jsonData["tasks"].is_array()) {
-            for (const auto& taskJson : jsonData["tasks"]) {
-                Task task;
-                task.setId(taskJson["id"]);
-                task.setDescription(taskJson["description"]);
-                task.setDueDate(taskJson["dueDate"]);
-                task.setPriority(taskJson["priority"]);
-                task.setCategory(taskJson["category"]);
-                task.setCompleted(taskJson["completed"]);
-                task.setRecurrence(static_cast<Recurrence>(taskJson["recurrence"].get<int>()));
-                
-                if (taskJson.contains("notes")) {
-                    task.setNotes(taskJson["notes"]);
-                }
-                
-                if (taskJson.contains("createdDate")) {
-                    task.setCreatedDate(taskJson["createdDate"]);
-                }
-                
-                if (taskJson.contains("projectGroup")) {
-                    task.setProjectGroup(taskJson["projectGroup"]);
-                    if (!task.getProjectGroup().empty()) {
-                        projectGroups.insert(task.getProjectGroup());
-                    }
-                }
-                
-                if (taskJson.contains("tags") && taskJson["tags"].is_array()) {
-                    std::vector<std::string> tags;
-                    for (const auto& tagJson : taskJson["tags"]) {
-                        tags.push_back(tagJson);
-                    }
-                    task.setTags(tags);
-                }
-
-                if (taskJson.contains("subtasks") && taskJson["subtasks"].is_array()) {
-                    for (const auto& subtaskJson : taskJson["subtasks"]) {
-                        Task subtask;
-                        subtask.setId(subtaskJson["id"]);
-                        subtask.setDescription(subtaskJson["description"]);
-                        subtask.setDueDate(subtaskJson["dueDate"]);
-                        subtask.setPriority(subtaskJson["priority"]);
-                        subtask.setCategory(subtaskJson["category"]);
-                        subtask.setCompleted(subtaskJson["completed"]);
-                        
-                        if (subtaskJson.contains("notes")) {
-                            subtask.setNotes(subtaskJson["notes"]);
-                        }
-                        
-                        if (subtaskJson.contains("tags") && subtaskJson["tags"].is_array()) {
-                            std::vector<std::string> tags;
-                            for (const auto& tagJson : subtaskJson["tags"]) {
-                                tags.push_back(tagJson);
-                            }
-                            subtask.setTags(tags);
-                        }
-                        
-                        task.addSubtask(subtask);
-                        
-                        if (subtask.getId() >= nextId) {
-                            nextId = subtask.getId() + 1;
-                        }
-                    }
-                }
-                
-                tasks.push_back(task);
-                
-                if (task.getId() >= nextId) {
-                    nextId = task.getId() + 1;
-                }
-            }
-        }
 
-        if (jsonData.contains("reminders") && jsonData["reminders"].is_array()) {
-            for (const auto& reminderJson : jsonData["reminders"]) {
-                Reminder reminder;
-                reminder.setTaskId(reminderJson["taskId"]);
-                reminder.setMessage(reminderJson["message"]);
-                reminder.setShown(reminderJson["shown"]);
-
-                std::string timeStr = reminderJson["time"];
-                std::tm tm = {};
-                std::istringstream ss(timeStr);
-                ss >> std::get_time(&tm, "%Y-%m-%d %H:%M");
-                reminder.setTime(std::chrono::system_clock::from_time_t(std::mktime(&tm)));
-                
-                reminders.push_back(reminder);
-            }
-        }
+    std::vector<Task> loadedTasks = tasks.release();
+    bool loaded = FileService::loadFromJson(dataFilePath, loadedTasks, reminders, templates, projectGroups, nextId,
+                                            snapshotSequence);
+    tasks.assign(std::move(loadedTasks));
+    searchIndex.clear();
+    return loaded;
+}
 
-        if (jsonData.contains("templates") && jsonData["templates"].is_array()) {
-            for (const auto& templateJson : jsonData["templates"]) {
-                TaskTemplate templ;
-                templ.setName(templateJson["name"]);
-                templ.setDescription(templateJson["description"]);
-                templ.setCategory(templateJson["category"]);
-                templ.setPriority(templateJson["priority"]);
-                templ.setRecurrence(static_cast<Recurrence>(templateJson["recurrence"].get<int>()));
-                
-                if (templateJson.contains("notes")) {
-                    templ.setNotes(templateJson["notes"]);
-                }
-                
-                if (templateJson.contains("projectGroup")) {
-                    templ.setProjectGroup(templateJson["projectGroup"]);
-                }
-                
-                if (templateJson.contains("subtaskDescriptions") && templateJson["subtaskDescriptions"].is_array()) {
-                    for (const auto& descJson : templateJson["subtaskDescriptions"]) {
-                        templ.addSubtaskDescription(descJson);
-                    }
-                }
-                
-                if (templateJson.contains("tags") && templateJson["tags"].is_array()) {
-                    std::vector<std::string> tags;
-                    for (const auto& tagJson : templateJson["tags"]) {
-                        tags.push_back(tagJson);
-                    }
-                    templ.setTags(tags);
-                }
-                
-                templates[templ.getName()] = templ;
-            }
-        }
-        
-        return true;
-    } catch (const std::exception& e) {
-        std::cerr << "Ошибка при загрузке из JSON: " << e.what() << std::endl;
+bool TaskController::saveToJson() {
+    if (!FileService::saveToJson(dataFilePath, tasks.all(), reminders, templates, projectGroups,
+                                 journal.getLastSequence())) {
         return false;
     }
+    return checkpoint();
 }
 
-bool TaskController::saveToJson() const {
-    json jsonData;
+Task* TaskController::findTaskById(int id) {
+    return tasks.find(id);
+}
 
-    json tasksJson = json::array();
-    for (const auto& task : tasks) {
-        json taskJson;
-        taskJson["id"] = task.getId();
-        taskJson["description"] = task.getDescription();
-        taskJson["dueDate"] = task.getDueDate();
-        taskJson["priority"] = task.getPriority();
-        taskJson["category"] = task.getCategory();
-        taskJson["completed"] = task.isCompleted();
-        taskJson["recurrence"] = static_cast<int>(task.getRecurrence());
-        taskJson["notes"] = task.getNotes();
-        taskJson["createdDate"] = task.getCreatedDate();
-        taskJson["projectGroup"] = task.getProjectGroup();
-        
-        json tagsJson = json::array();
-        for (const auto& tag : task.getTags()) {
-            tagsJson.push_back(tag);
+const Task* TaskController::findTaskById(int id) const {
+    return tasks.find(id);
+}
+
+Task* TaskController::findSubtaskById(int id, Task** parentTask) {
+    const Task* parent = nullptr;
+    const Task* subtask = std::as_const(*this).findSubtaskById(id, &parent);
+    if (subtask && parentTask) {
+        *parentTask = const_cast<Task*>(parent);
+    }
+    return const_cast<Task*>(subtask);
+}
+
+const Task* TaskController::findSubtaskById(int id, const Task** parentTask) const {
+    const Task* subtask = tasks.find(id);
+    if (!subtask || !subtask->isSubtask()) {
+        return nullptr;
+    }
+
+    if (parentTask) {
+        *parentTask = tasks.find(subtask->getParentId());
+    }
+    return subtask;
+}
+
+int TaskController::createTaskFromTemplate(const std::string& templateName) {
+    if (templates.find(templateName) == templates.end()) {
+        return -1;
+    }
+
+    return createTaskFromTemplate(templateName, Date::today().toString());
+}
+
+
+bool TaskController::checkpoint() {
+    const int64_t sequence = journal.getLastSequence();
+
+    auto changed = std::make_shared<std::map<int32_t, FileService::SegmentData>>();
+    int64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(dirtyMutex);
+        generation = ++checkpointGeneration;
+        for (const auto& [key, dirtySequence] : dirtySegments) {
+            (*changed)[key];
         }
-        taskJson["tags"] = tagsJson;
-
-        if (!task.getSubtasks().empty()) {
-            json subtasksJson = json::array();
-            for (const auto& subtask : task.getSubtasks()) {
-                json subtaskJson;
-                subtaskJson["id"] = subtask.getId();
-                subtaskJson["description"] = subtask.getDescription();
-                subtaskJson["dueDate"] = subtask.getDueDate();
-                subtaskJson["priority"] = subtask.getPriority();
-                subtaskJson["category"] = subtask.getCategory();
-                subtaskJson["completed"] = subtask.isCompleted();
-                subtaskJson["notes"] = subtask.getNotes();
-                
-                json subtaskTagsJson = json::array();
-                for (const auto& tag : subtask.getTags()) {
-                    subtaskTagsJson.push_back(tag);
-                }
-                subtaskJson["tags"] = subtaskTagsJson;
-                
-                subtasksJson.push_back(subtaskJson);
+    }
+
+    if (!changed->empty()) {
+        for (const auto& task : tasks) {
+            auto it = changed->find(task.getId() / SEGMENT_SIZE);
+            if (it != changed->end()) {
+                it->second.tasks.push_back(task);
             }
-            taskJson["subtasks"] = subtasksJson;
         }
-        
-        tasksJson.push_back(taskJson);
-    }
-    jsonData["tasks"] = tasksJson;
-
-    json remindersJson = json::array();
-    for (const auto& reminder : reminders) {
-        json reminderJson;
-        reminderJson["taskId"] = reminder.getTaskId();
-        reminderJson["message"] = reminder.getMessage();
-        reminderJson["shown"] = reminder.isShown();
-
-        auto timeT = std::chrono::system_clock::to_time_t(reminder.getTime());
-        std::tm* tm = std::localtime(&timeT);
-        char buffer[20];
-        std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M", tm);
-        reminderJson["time"] = std::string(buffer);
-        
-        remindersJson.push_back(reminderJson);
-    }
-    jsonData["reminders"] = remindersJson;
-
-    json templatesJson = json::array();
-    for (const auto& [name, templ] : templates) {
-        json templateJson;
-        templateJson["name"] = templ.getName();
-        templateJson["description"] = templ.getDescription();
-        templateJson["category"] = templ.getCategory();
-        templateJson["priority"] = templ.getPriority();
-        templateJson["recurrence"] = static_cast<int>(templ.getRecurrence());
-        templateJson["notes"] = templ.getNotes();
-        templateJson["projectGroup"] = templ.getProjectGroup();
-        
-        json subtaskDescJson = json::array();
-        for (const auto& desc : templ.getSubtaskDescriptions()) {
-            subtaskDescJson.push_back(desc);
+
+        auto remindersIt = changed->find(FileService::SegmentManifest::REMINDERS_SEGMENT);
+        if (remindersIt != changed->end()) {
+            remindersIt->second.reminders = reminders;
         }
-        templateJson["subtaskDescriptions"] = subtaskDescJson;
-        
-        json tagsJson = json::array();
-        for (const auto& tag : templ.getTags()) {
-            tagsJson.push_back(tag);
+
+        auto templatesIt = changed->find(FileService::SegmentManifest::TEMPLATES_SEGMENT);
+        if (templatesIt != changed->end()) {
+            templatesIt->second.templates = templates;
         }
-        templateJson["tags"] = tagsJson;
-        
-        templatesJson.push_back(templateJson);
     }
-    jsonData["templates"] = templatesJson;
 
-    std::ofstream file(dataFilePath);
-    if (!file.is_open()) {
-        return false;
+    // Файлы сегментов не перезаписываются: контрольная точка без новых записей
+    // журнала (после сбоя записи в журнал или экспорта) берет следующий свободный номер.
+    int64_t fileSequence = sequence;
+    for (const auto& [key, existingSequence] : segmentFiles) {
+        fileSequence = std::max(fileSequence, existingSequence + 1);
     }
-    
-    file << jsonData.dump(4);
-    
+    for (const auto& [key, segment] : *changed) {
+        if (segment.empty()) {
+            segmentFiles.erase(key);
+        } else {
+            segmentFiles[key] = fileSequence;
+        }
+    }
+
+    auto manifest = std::make_shared<FileService::SegmentManifest>();
+    manifest->journalSequence = sequence;
+    manifest->segmentSize = SEGMENT_SIZE;
+    manifest->segments = segmentFiles;
+    manifest->order.reserve(tasks.size());
+    for (const auto& task : tasks) {
+        manifest->order.push_back(task.getId());
+    }
+
+    if (!journal.rotate()) {
+        Logger::getInstance().warning("Журнал изменений продолжит запись в текущий файл: " + journal.getFilePath());
+    }
+
+    std::string directory = segmentDirectory;
+    snapshotWriter.submit(sequence, [this, manifest, changed, directory, generation]() {
+        if (!FileService::saveSegments(directory, *manifest, *changed)) {
+            Logger::getInstance().error("Не удалось записать контрольную точку в каталог: " + directory);
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(dirtyMutex);
+        for (auto it = dirtySegments.begin(); it != dirtySegments.end();) {
+            it = it->second < generation ? dirtySegments.erase(it) : std::next(it);
+        }
+        return true;
+    });
+
+    snapshotSequence = sequence;
+    modified = false;
     return true;
 }
 
-Task* TaskController::findTaskById(int id) {
-    for (auto& task : tasks) {
-        if (task.getId() == id) {
-            return &task;
-        }
-    }
-    return nullptr;
+void TaskController::markSegmentDirty(int32_t key) {
+    std::lock_guard<std::mutex> lock(dirtyMutex);
+    dirtySegments[key] = checkpointGeneration;
 }
 
-const Task* TaskController::findTaskById(int id) const {
+void TaskController::markTaskDirty(int taskId) {
+    markSegmentDirty(taskId / SEGMENT_SIZE);
+}
+
+void TaskController::markRemindersDirty() {
+    markSegmentDirty(FileService::SegmentManifest::REMINDERS_SEGMENT);
+}
+
+void TaskController::markTemplateDirty(const std::string&) {
+    markSegmentDirty(FileService::SegmentManifest::TEMPLATES_SEGMENT);
+}
+
+void TaskController::markAllDirty() {
+    segmentFiles.clear();
     for (const auto& task : tasks) {
-        if (task.getId() == id) {
-            return &task;
-        }
+        markTaskDirty(task.getId());
     }
-    return nullptr;
+    markRemindersDirty();
+    markTemplateDirty("");
+    modified = true;
 }
 
-Task* TaskController::findSubtaskById(int id, Task** parentTask) {
-    for (auto& task : tasks) {
-        for (auto& subtask : task.getSubtasks()) {
-            if (subtask.getId() == id) {
-                if (parentTask) {
-                    *parentTask = &task;
-                }
-                return const_cast<Task*>(&subtask);
-            }
-        }
+void TaskController::journalRecord(json record) {
+    modified = true;
+    if (replayingJournal) {
+        return;
     }
-    return nullptr;
-}
 
-const Task* TaskController::findSubtaskById(int id, const Task** parentTask) const {
-    for (const auto& task : tasks) {
-        for (const auto& subtask : task.getSubtasks()) {
-            if (subtask.getId() == id) {
-                if (parentTask) {
-                    *parentTask = &task;
-                }
-                return &subtask;
-            }
-        }
+    // Изменение уже применено в памяти и отмечено грязным: если журнал его не
+    // принял, оно сохраняется сразу контрольной точкой, а не теряется при сбое.
+    if (!journal.append(std::move(record))) {
+        Logger::getInstance().error("Изменение не записано в журнал, сохраняется контрольной точкой: " +
+                                    journal.getFilePath());
+        checkpoint();
+        return;
+    }
+
+    if (journal.getRecordCount() >= CHECKPOINT_INTERVAL) {
+        checkpoint();
     }
-    return nullptr;
 }
 
-int TaskController::createTaskFromTemplate(const std::string& templateName) {
-    if (templates.find(templateName) == templates.end()) {
-        return -1;
+void TaskController::journalTask(const Task& task) {
+    int slot = tasks.slotOf(task.getId());
+    if (slot != IdIndex::NOT_FOUND) {
+        tasks.refresh(slot);
+    }
+    searchIndex.update(task);
+    markTaskDirty(task.getId());
+    if (replayingJournal) {
+        modified = true;
+        return;
     }
+    journalRecord({{"op", "putTask"}, {"task", FileService::taskToJson(task)}});
+}
 
-    std::time_t now = std::time(nullptr);
-    std::tm* now_tm = std::localtime(&now);
-    char buffer[11];
-    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d", now_tm);
-    std::string today(buffer);
+void TaskController::replayJournal() {
+    replayingJournal = true;
+    size_t applied = journal.replay(snapshotSequence, [this](const json& record) {
+        applyJournalRecord(record);
+    });
+    replayingJournal = false;
 
-    return createTaskFromTemplate(templateName, today);
+    if (applied > 0) {
+        modified = true;
+        Logger::getInstance().info("Восстановлено изменений из журнала: " + std::to_string(applied));
+    }
 }
+
+void TaskController::applyJournalRecord(const json& record) {
+    const std::string op = record.at("op");
+
+    if (op == "putTask") {
+        for (const auto& task : FileService::jsonToTaskTree(record.at("task"))) {
+            markTaskDirty(task.getId());
+            Task* existing = findTaskById(task.getId());
+            if (existing) {
+                *existing = task;
+                tasks.refresh(tasks.slotOf(task.getId()));
+            } else {
+                tasks.push_back(task);
+            }
+            searchIndex.update(task);
+
+            if (!task.getProjectGroup().empty()) {
+                projectGroups.insert(task.getProjectGroup());
+            }
+            if (task.getId() >= nextId) {
+                nextId = task.getId() + 1;
+            }
+        }
+    } else if (op == "deleteTask") {
+        deleteTask(record.at("id").get<int>());
+    } else if (op == "putTemplate") {
+        TaskTemplate templ = FileService::jsonToTemplate(record.at("template"));
+        templates[templ.getName()] = templ;
+        markTemplateDirty(templ.getName());
+    } else if (op == "deleteTemplate") {
+        deleteTemplate(record.at("name").get<std::string>());
+    } else if (op == "addReminder") {
+        reminders.push_back(FileService::jsonToReminder(record.at("reminder")));
+        markRemindersDirty();
+    } else if (op == "removeReminders") {
+        removeReminder(record.at("taskId").get<int>());
+    } else if (op == "setReminders") {
+        reminders.clear();
+        for (const auto& reminderJson : record.at("reminders")) {
+            reminders.push_back(FileService::jsonToReminder(reminderJson));
+        }
+        markRemindersDirty();
+    } else if (op == "renameGroup") {
+        renameProjectGroup(record.at("from").get<std::string>(), record.at("to").get<std::string>());
+    } else if (op == "deleteGroup") {
+        deleteProjectGroup(record.at("name").get<std::string>());
+    } else if (op == "sort") {
+        const std::string by = record.at("by");
+        if (by == "priority") {
+            sortByPriority();
+        } else if (by == "dueDate") {
+            sortByDueDate();
+        } else if (by == "category") {
+            sortByCategory();
+        } else if (auto spec = SortSpec::parse(by)) {
+            sortBy(*spec);
+        }
+    } else {
+        Logger::getInstance().warning("Неизвестная операция в журнале изменений: " + op);
+    }
+}
\ No newline at end of file
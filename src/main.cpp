@@ -2,9 +2,11 @@
 #include "../include/controllers/menu_controller.h"
 #include "../include/services/logger.h"
 #include "../include/services/input_validator.h"
+#include "../include/services/task_query.h"
+#include "../include/views/task_view.h"
 #include <iostream>
 
-int main() {
+int main(int argc, char* argv[]) {
     Logger& logger = Logger::getInstance();
     logger.setLevel(LogLevel::INFO);
     logger.setLogFile("todolist.log");
@@ -15,6 +17,19 @@ int main() {
 
     try {
         TaskController taskController("tasks.json");
+
+        // Пакетный режим: TaskManager --query "<запрос>" выводит подходящие задачи.
+        if (argc == 3 && std::string(argv[1]) == "--query") {
+            std::string error;
+            auto query = TaskQuery::compile(argv[2], &error);
+            if (!query) {
+                std::cerr << "Ошибка в запросе: " << error << std::endl;
+                return 2;
+            }
+            TaskView::displayTaskList(taskController.selectTasks(*query));
+            return 0;
+        }
+
         MenuController menuController(taskController);
         menuController.runMainMenu();
         logger.info("Нормальное завершение приложения");
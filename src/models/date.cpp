@@ -0,0 +1,20 @@
+#include "../../include/models/date.h"
+#include "../../include/services/clock.h"
+#include <cstdio>
+
+Date Date::today() {
+    return Clock::today();
+}
+
+std::string Date::toString() const {
+    if (!isValid()) {
+        return "";
+    }
+
+    Civil date = civil();
+    // Год из номера дня int32 занимает до 8 символов, но размер берется под
+    // любые int, чтобы snprintf заведомо не обрезал строку.
+    char buffer[36];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", date.year, date.month, date.day);
+    return buffer;
+}
@@ -0,0 +1,94 @@
+#include "../../include/models/id_index.h"
+#include <algorithm>
+#include <bit>
+
+IdIndex::IdIndex() : count(0), shift(32) {
+    rehash(MIN_CAPACITY);
+}
+
+size_t IdIndex::locate(int id) const {
+    const size_t mask = entries.size() - 1;
+    for (size_t i = bucket(id);; i = (i + 1) & mask) {
+        if (entries[i].id == id || entries[i].id == EMPTY) {
+            return i;
+        }
+    }
+}
+
+void IdIndex::rehash(size_t capacity) {
+    std::vector<Entry> old(capacity, Entry{EMPTY, 0});
+    old.swap(entries);
+    shift = 32 - static_cast<unsigned>(std::countr_zero(capacity));
+
+    for (const auto& entry : old) {
+        if (entry.id != EMPTY) {
+            entries[locate(entry.id)] = entry;
+        }
+    }
+}
+
+int IdIndex::find(int id) const {
+    const Entry& entry = entries[locate(id)];
+    return entry.id == EMPTY ? NOT_FOUND : entry.value;
+}
+
+bool IdIndex::insert(int id, int value) {
+    if (id == EMPTY) {
+        return false;
+    }
+    if ((count + 1) * 4 > entries.size() * 3) {
+        rehash(entries.size() * 2);
+    }
+
+    Entry& entry = entries[locate(id)];
+    if (entry.id == id) {
+        return false;
+    }
+    entry = Entry{id, value};
+    count++;
+    return true;
+}
+
+void IdIndex::assign(int id, int value) {
+    if (!insert(id, value) && id != EMPTY) {
+        entries[locate(id)].value = value;
+    }
+}
+
+bool IdIndex::erase(int id) {
+    if (id == EMPTY) {
+        return false;
+    }
+
+    const size_t mask = entries.size() - 1;
+    size_t hole = locate(id);
+    if (entries[hole].id == EMPTY) {
+        return false;
+    }
+
+    // Запись из цепочки переносится в освободившуюся ячейку, если ячейка лежит
+    // между ее домашней позицией и текущей.
+    for (size_t i = (hole + 1) & mask; entries[i].id != EMPTY; i = (i + 1) & mask) {
+        size_t home = bucket(entries[i].id);
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            entries[hole] = entries[i];
+            hole = i;
+        }
+    }
+    entries[hole].id = EMPTY;
+    count--;
+    return true;
+}
+
+void IdIndex::clear() {
+    count = 0;
+    entries.assign(MIN_CAPACITY, Entry{EMPTY, 0});
+    shift = 32 - static_cast<unsigned>(std::countr_zero(MIN_CAPACITY));
+}
+
+void IdIndex::reserve(size_t size) {
+    size_t capacity = std::bit_ceil(std::max(MIN_CAPACITY, size + size / 3 + 1));
+    if (capacity > entries.size()) {
+        rehash(capacity);
+    }
+}
@@ -1,9 +1,10 @@
 #include "../../include/models/reminder.h"
+#include "../../include/services/clock.h"
 #include <iomanip>
 #include <sstream>
 
 Reminder::Reminder() : taskId(0), shown(false) {
-    time = std::chrono::system_clock::now();
+    time = Clock::now();
 }
 
 Reminder::Reminder(int taskId, const std::string& message, 
@@ -12,16 +13,9 @@ Reminder::Reminder(int taskId, const std::string& message,
 }
 
 bool Reminder::isTimeToShow() const {
-    auto now = std::chrono::system_clock::now();
-    return !shown && (time <= now);
+    return !shown && (time <= Clock::now());
 }
 
 std::string Reminder::getFormattedTime() const {
-    auto timeT = std::chrono::system_clock::to_time_t(time);
-    std::tm* tm = std::localtime(&timeT);
-    
-    std::ostringstream oss;
-    oss << std::put_time(tm, "%Y-%m-%d %H:%M");
-    
-    return oss.str();
+    return Clock::formatMinute(time);
 }
\ No newline at end of file
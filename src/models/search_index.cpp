@@ -0,0 +1,267 @@
+#include "../../include/models/search_index.h"
+#include "../../include/models/task_store.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+    const std::vector<int> NO_TASKS;
+
+    // Подстрока запроса может начинаться или заканчиваться посреди символа, а
+    // сложение меняет байты двухбайтовых букв целиком (Р: D0 A0 -> D1 80). Обрывки
+    // по краям в сложенном словаре не найти, поэтому они отбрасываются.
+    std::string_view trimPartialSequences(std::string_view word) {
+        auto isContinuation = [](char c) { return (static_cast<unsigned char>(c) & 0xC0) == 0x80; };
+        size_t begin = 0;
+        while (begin < word.size() && isContinuation(word[begin])) {
+            begin++;
+        }
+        word.remove_prefix(begin);
+
+        size_t lead = word.size();
+        while (lead > 0 && word.size() - lead < 4 && isContinuation(word[lead - 1])) {
+            lead--;
+        }
+        if (lead > 0) {
+            unsigned char c = static_cast<unsigned char>(word[lead - 1]);
+            size_t length = c < 0x80 ? 1 : (c & 0xE0) == 0xC0 ? 2 : (c & 0xF0) == 0xE0 ? 3 : 4;
+            if (word.size() - (lead - 1) < length) {
+                word.remove_suffix(word.size() - (lead - 1));
+            }
+        }
+        return word;
+    }
+}
+
+uint32_t SearchIndex::wordId(std::string_view word) {
+    auto it = wordIds.find(word);
+    if (it != wordIds.end()) {
+        return it->second;
+    }
+
+    uint32_t id = static_cast<uint32_t>(words.size());
+    words.emplace_back(word);
+    postings.emplace_back();
+    wordIds.emplace(words.back(), id);
+    addTrigrams(id);
+    return id;
+}
+
+void SearchIndex::addTrigrams(uint32_t word) {
+    std::string_view text = words[word];
+    for (size_t pos = 0; pos + 3 <= text.size(); ++pos) {
+        std::vector<uint32_t>& list = trigramWords[trigram(text, pos)];
+        // Номера слов только растут, список остается упорядоченным.
+        if (list.empty() || list.back() != word) {
+            list.push_back(word);
+        }
+    }
+}
+
+std::vector<uint32_t> SearchIndex::wordsContaining(std::string_view fragment) const {
+    std::vector<uint32_t> result;
+    if (fragment.size() < 3) {
+        for (size_t word = 0; word < words.size(); ++word) {
+            if (words[word].find(fragment) != std::string::npos) {
+                result.push_back(static_cast<uint32_t>(word));
+            }
+        }
+        return result;
+    }
+
+    // Начинаем с самого короткого списка, остальные только сужают его.
+    std::vector<const std::vector<uint32_t>*> lists;
+    for (size_t pos = 0; pos + 3 <= fragment.size(); ++pos) {
+        auto it = trigramWords.find(trigram(fragment, pos));
+        if (it == trigramWords.end()) {
+            return result;
+        }
+        lists.push_back(&it->second);
+    }
+    std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) { return a->size() < b->size(); });
+
+    result = *lists.front();
+    for (size_t i = 1; i < lists.size() && !result.empty(); ++i) {
+        std::vector<uint32_t> narrowed;
+        std::set_intersection(result.begin(), result.end(), lists[i]->begin(), lists[i]->end(),
+                              std::back_inserter(narrowed));
+        result = std::move(narrowed);
+    }
+
+    // Все триграммы на месте еще не значат, что они идут подряд.
+    if (fragment.size() > 3) {
+        result.erase(std::remove_if(result.begin(), result.end(),
+                                    [&](uint32_t word) { return words[word].find(fragment) == std::string::npos; }),
+                     result.end());
+    }
+    return result;
+}
+
+void SearchIndex::addPosting(uint32_t word, int taskId) {
+    std::vector<int>& list = postings[word];
+    if (list.empty() || list.back() < taskId) {
+        list.push_back(taskId);
+        return;
+    }
+
+    auto it = std::lower_bound(list.begin(), list.end(), taskId);
+    if (it == list.end() || *it != taskId) {
+        list.insert(it, taskId);
+    }
+}
+
+void SearchIndex::removePosting(uint32_t word, int taskId) {
+    std::vector<int>& list = postings[word];
+    auto it = std::lower_bound(list.begin(), list.end(), taskId);
+    if (it != list.end() && *it == taskId) {
+        list.erase(it);
+    }
+}
+
+std::vector<uint32_t> SearchIndex::collectWords(const Task& task) {
+    std::vector<uint32_t> result;
+    auto add = [&](std::string_view word) { result.push_back(wordId(word)); };
+
+    forEachWord(task.getDescription(), add);
+    forEachWord(task.getCategory(), add);
+    forEachWord(task.getNotes(), add);
+    for (const auto& tag : task.getTags()) {
+        forEachWord(tag, add);
+    }
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+void SearchIndex::build(const TaskStore& store) {
+    clear();
+    documents.reserve(store.size());
+
+    for (const auto& task : store) {
+        std::vector<uint32_t> taskWords = collectWords(task);
+        for (uint32_t word : taskWords) {
+            postings[word].push_back(task.getId());
+        }
+        documents[task.getId()] = std::move(taskWords);
+    }
+
+    // После сортировки задач порядок хранения не совпадает с порядком ID.
+    for (auto& list : postings) {
+        std::sort(list.begin(), list.end());
+    }
+    ready = true;
+}
+
+void SearchIndex::clear() {
+    wordIds.clear();
+    words.clear();
+    postings.clear();
+    documents.clear();
+    trigramWords.clear();
+    ready = false;
+}
+
+void SearchIndex::update(const Task& task) {
+    if (!ready) {
+        return;
+    }
+
+    std::vector<uint32_t> newWords = collectWords(task);
+    std::vector<uint32_t>& oldWords = documents[task.getId()];
+
+    std::vector<uint32_t> removed;
+    std::set_difference(oldWords.begin(), oldWords.end(), newWords.begin(), newWords.end(),
+                        std::back_inserter(removed));
+    for (uint32_t word : removed) {
+        removePosting(word, task.getId());
+    }
+
+    std::vector<uint32_t> added;
+    std::set_difference(newWords.begin(), newWords.end(), oldWords.begin(), oldWords.end(),
+                        std::back_inserter(added));
+    for (uint32_t word : added) {
+        addPosting(word, task.getId());
+    }
+
+    oldWords = std::move(newWords);
+}
+
+void SearchIndex::remove(int taskId) {
+    if (!ready) {
+        return;
+    }
+
+    auto it = documents.find(taskId);
+    if (it == documents.end()) {
+        return;
+    }
+
+    for (uint32_t word : it->second) {
+        removePosting(word, taskId);
+    }
+    documents.erase(it);
+}
+
+const std::vector<int>& SearchIndex::exact(std::string_view word) const {
+    auto it = wordIds.find(word);
+    return it == wordIds.end() ? NO_TASKS : postings[it->second];
+}
+
+std::vector<int> SearchIndex::containing(std::string_view fragment) const {
+    std::vector<int> result;
+    size_t lists = 0;
+    for (uint32_t word : wordsContaining(fragment)) {
+        if (!postings[word].empty()) {
+            result.insert(result.end(), postings[word].begin(), postings[word].end());
+            lists++;
+        }
+    }
+
+    if (lists > 1) {
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+    }
+    return result;
+}
+
+std::optional<std::vector<int>> SearchIndex::substringCandidates(std::string_view query) const {
+    std::vector<std::vector<int>> lists;
+    forEachWord(query, [&](std::string_view word) {
+        word = trimPartialSequences(word);
+        if (word.empty()) {
+            return;
+        }
+        if (lists.empty() || !lists.back().empty()) {
+            lists.push_back(containing(word));
+        }
+    });
+    if (lists.empty()) {
+        return std::nullopt;
+    }
+
+    std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b) { return a.size() < b.size(); });
+    std::vector<int> result = std::move(lists.front());
+    for (size_t i = 1; i < lists.size() && !result.empty(); ++i) {
+        std::vector<int> narrowed;
+        std::set_intersection(result.begin(), result.end(), lists[i].begin(), lists[i].end(),
+                              std::back_inserter(narrowed));
+        result = std::move(narrowed);
+    }
+    return result;
+}
+
+std::optional<std::vector<int>> SearchIndex::wordCandidates(std::string_view query) const {
+    std::optional<std::vector<int>> result;
+    forEachWord(query, [&](std::string_view word) {
+        const std::vector<int>& matches = exact(word);
+        if (!result) {
+            result = matches;
+            return;
+        }
+
+        std::vector<int> merged;
+        std::set_union(result->begin(), result->end(), matches.begin(), matches.end(), std::back_inserter(merged));
+        *result = std::move(merged);
+    });
+    return result;
+}
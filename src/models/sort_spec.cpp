@@ -0,0 +1,326 @@
+#include "../../include/models/sort_spec.h"
+#include <algorithm>
+#include <bit>
+#include <unordered_map>
+
+namespace {
+
+// Меньше этого числа задач проще сравнивать напрямую.
+constexpr size_t MIN_RADIX_SIZE = 64;
+constexpr int64_t NO_DUE = Date::NONE;
+
+struct FieldName {
+    std::string_view name;
+    SortSpec::Field field;
+};
+
+constexpr FieldName FIELD_NAMES[] = {
+    {"duedate", SortSpec::Field::Due},         {"due", SortSpec::Field::Due},
+    {"priority", SortSpec::Field::Priority},   {"prio", SortSpec::Field::Priority},
+    {"category", SortSpec::Field::Category},   {"cat", SortSpec::Field::Category},
+    {"description", SortSpec::Field::Description},
+    {"id", SortSpec::Field::Id},
+    {"completed", SortSpec::Field::Completed}, {"done", SortSpec::Field::Completed},
+};
+
+std::string_view canonicalName(SortSpec::Field field) {
+    switch (field) {
+        case SortSpec::Field::Due:
+            return "dueDate";
+        case SortSpec::Field::Priority:
+            return "priority";
+        case SortSpec::Field::Category:
+            return "category";
+        case SortSpec::Field::Description:
+            return "description";
+        case SortSpec::Field::Id:
+            return "id";
+        case SortSpec::Field::Completed:
+            return "completed";
+    }
+    return "id";
+}
+
+std::string lowerAscii(std::string_view text) {
+    std::string result(text);
+    for (auto& c : result) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return result;
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+template <typename T>
+int threeWay(const T& a, const T& b) {
+    return a < b ? -1 : (b < a ? 1 : 0);
+}
+
+// Значения ключа для строк rows; у задач без срока - меньше любой даты.
+std::vector<int64_t> keyValues(SortSpec::Field field, const std::vector<Task>& source,
+                               const std::vector<uint32_t>& rows) {
+    std::vector<int64_t> values(rows.size());
+    if (field == SortSpec::Field::Category) {
+        // Ранг категории среди встречающихся, по возрастанию строки.
+        std::unordered_map<uint32_t, int64_t> ranks;
+        std::vector<Symbol> distinct;
+        for (uint32_t row : rows) {
+            Symbol category = source[row].getCategorySymbol();
+            if (ranks.emplace(category.getId(), 0).second) {
+                distinct.push_back(category);
+            }
+        }
+        std::sort(distinct.begin(), distinct.end(), [](Symbol a, Symbol b) { return a.str() < b.str(); });
+        for (size_t rank = 0; rank < distinct.size(); ++rank) {
+            ranks[distinct[rank].getId()] = static_cast<int64_t>(rank);
+        }
+        for (size_t i = 0; i < rows.size(); ++i) {
+            values[i] = ranks[source[rows[i]].getCategorySymbol().getId()];
+        }
+        return values;
+    }
+
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const Task& task = source[rows[i]];
+        switch (field) {
+            case SortSpec::Field::Due: {
+                Date due = task.getDue();
+                values[i] = due.isValid() ? due.days() : NO_DUE;
+                break;
+            }
+            case SortSpec::Field::Priority:
+                values[i] = task.getPriority();
+                break;
+            case SortSpec::Field::Id:
+                values[i] = task.getId();
+                break;
+            case SortSpec::Field::Completed:
+                values[i] = task.isCompleted() ? 1 : 0;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Задачи без срока остаются меньше всех, но не растягивают диапазон до Date::NONE.
+    if (field == SortSpec::Field::Due) {
+        int64_t earliest = 0;
+        bool found = false;
+        for (int64_t value : values) {
+            if (value != NO_DUE && (!found || value < earliest)) {
+                earliest = value;
+                found = true;
+            }
+        }
+        for (auto& value : values) {
+            value = value == NO_DUE ? 0 : value - earliest + 1;
+        }
+    }
+    return values;
+}
+
+struct PackedRow {
+    uint64_t key;
+    uint32_t row;
+};
+
+// Устойчивая поразрядная сортировка по младшим bits битам key, по байту за проход.
+void radixSort(std::vector<PackedRow>& items, int bits) {
+    std::vector<PackedRow> buffer(items.size());
+    for (int shift = 0; shift < bits; shift += 8) {
+        size_t counts[257] = {};
+        for (const auto& item : items) {
+            counts[((item.key >> shift) & 0xFF) + 1]++;
+        }
+        if (counts[((items.front().key >> shift) & 0xFF) + 1] == items.size()) {
+            continue;
+        }
+        for (size_t digit = 1; digit < 257; ++digit) {
+            counts[digit] += counts[digit - 1];
+        }
+        for (const auto& item : items) {
+            buffer[counts[(item.key >> shift) & 0xFF]++] = item;
+        }
+        items.swap(buffer);
+    }
+}
+
+}
+
+std::optional<SortSpec> SortSpec::parse(std::string_view text, bool defaultAscending, std::string* error) {
+    auto fail = [error](std::string message) -> std::optional<SortSpec> {
+        if (error) {
+            *error = std::move(message);
+        }
+        return std::nullopt;
+    };
+
+    std::vector<Key> keys;
+    while (true) {
+        size_t comma = text.find(',');
+        std::string_view part = trim(text.substr(0, comma));
+        if (part.empty()) {
+            return fail("Пустой ключ сортировки");
+        }
+
+        size_t space = part.find_first_of(" \t");
+        std::string name = lowerAscii(part.substr(0, space));
+        std::string direction = space == std::string_view::npos ? "" : lowerAscii(trim(part.substr(space)));
+
+        auto known = std::find_if(std::begin(FIELD_NAMES), std::end(FIELD_NAMES),
+                                  [&name](const FieldName& field) { return field.name == name; });
+        if (known == std::end(FIELD_NAMES)) {
+            return fail("Неизвестное поле сортировки: " + std::string(part.substr(0, space)));
+        }
+        if (!direction.empty() && direction != "asc" && direction != "desc") {
+            return fail("Ожидалось asc или desc: " + direction);
+        }
+        keys.push_back(Key{known->field, direction.empty() ? defaultAscending : direction == "asc"});
+
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        text.remove_prefix(comma + 1);
+    }
+    return SortSpec(std::move(keys));
+}
+
+std::string SortSpec::toString() const {
+    std::string result;
+    for (const auto& key : keys) {
+        if (!result.empty()) {
+            result += ", ";
+        }
+        result += canonicalName(key.field);
+        result += key.ascending ? " asc" : " desc";
+    }
+    return result;
+}
+
+SortSpec SortSpec::thenById() const {
+    SortSpec result = *this;
+    bool hasId = std::any_of(keys.begin(), keys.end(), [](const Key& key) { return key.field == Field::Id; });
+    if (!hasId) {
+        result.keys.push_back(Key{Field::Id, true});
+    }
+    return result;
+}
+
+bool SortSpec::lessByKeys(const Task& a, const Task& b, size_t firstKey) const {
+    for (size_t i = firstKey; i < keys.size(); ++i) {
+        int order = 0;
+        switch (keys[i].field) {
+            case Field::Due:
+                order = threeWay(a.getDue(), b.getDue());
+                break;
+            case Field::Priority:
+                order = threeWay(a.getPriority(), b.getPriority());
+                break;
+            case Field::Category:
+                order = a.getCategorySymbol() == b.getCategorySymbol() ? 0 : a.getCategory().compare(b.getCategory());
+                break;
+            case Field::Description:
+                order = a.getDescription().compare(b.getDescription());
+                break;
+            case Field::Id:
+                order = threeWay(a.getId(), b.getId());
+                break;
+            case Field::Completed:
+                order = threeWay(a.isCompleted(), b.isCompleted());
+                break;
+        }
+        if (order != 0) {
+            return keys[i].ascending ? order < 0 : order > 0;
+        }
+    }
+    return false;
+}
+
+void SortSpec::sortRows(const std::vector<Task>& source, std::vector<uint32_t>& rows) const {
+    auto byTask = [this, &source](uint32_t a, uint32_t b) { return less(source[a], source[b]); };
+    if (rows.size() < MIN_RADIX_SIZE || keys.empty() || keys.front().field == Field::Description) {
+        std::stable_sort(rows.begin(), rows.end(), byTask);
+        return;
+    }
+
+    // Упаковка ведущих ключей в 64 бита: каждый занимает ширину своего диапазона.
+    std::vector<PackedRow> items(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        items[i] = PackedRow{0, rows[i]};
+    }
+    int bits = 0;
+    size_t packedKeys = 0;
+    for (const auto& key : keys) {
+        if (key.field == Field::Description) {
+            break;
+        }
+
+        std::vector<int64_t> values = keyValues(key.field, source, rows);
+        auto [low, high] = std::minmax_element(values.begin(), values.end());
+        uint64_t range = static_cast<uint64_t>(*high - *low);
+        int width = static_cast<int>(std::bit_width(range));
+        if (bits + width > 64) {
+            break;
+        }
+
+        int64_t base = *low;
+        for (size_t i = 0; i < items.size(); ++i) {
+            uint64_t value = static_cast<uint64_t>(values[i] - base);
+            if (!key.ascending) {
+                value = range - value;
+            }
+            items[i].key = width == 0 ? items[i].key : (items[i].key << width) | value;
+        }
+        bits += width;
+        packedKeys++;
+    }
+
+    if (packedKeys == keys.size()) {
+        radixSort(items, bits);
+    } else {
+        // Остальные ключи сравниваются по задачам только при равной упакованной части.
+        std::stable_sort(items.begin(), items.end(), [&](const PackedRow& a, const PackedRow& b) {
+            if (a.key != b.key) {
+                return a.key < b.key;
+            }
+            return lessByKeys(source[a.row], source[b.row], packedKeys);
+        });
+    }
+
+    for (size_t i = 0; i < items.size(); ++i) {
+        rows[i] = items[i].row;
+    }
+}
+
+std::vector<uint32_t> SortSpec::order(const std::vector<Task>& tasks) const {
+    std::vector<uint32_t> rows(tasks.size());
+    for (size_t row = 0; row < tasks.size(); ++row) {
+        rows[row] = static_cast<uint32_t>(row);
+    }
+    sortRows(tasks, rows);
+    return rows;
+}
+
+void SortSpec::sort(TaskSelection& tasks) const {
+    tasks.reorderRows([this](const std::vector<Task>& source, std::vector<uint32_t>& rows) { sortRows(source, rows); });
+}
+
+void SortSpec::sort(std::vector<Task>& tasks) const {
+    std::vector<uint32_t> rows = order(tasks);
+    std::vector<Task> sorted;
+    sorted.reserve(tasks.size());
+    for (uint32_t row : rows) {
+        sorted.push_back(std::move(tasks[row]));
+    }
+    tasks = std::move(sorted);
+}
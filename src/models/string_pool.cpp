@@ -0,0 +1,89 @@
+#include "../../include/models/string_pool.h"
+#include "../../include/models/case_folding.h"
+#include <mutex>
+#include <stdexcept>
+
+StringPool::StringPool() : chunks(new std::atomic<Entry*>[MAX_CHUNKS]), count(1) {
+    for (size_t i = 0; i < MAX_CHUNKS; ++i) {
+        chunks[i].store(nullptr, std::memory_order_relaxed);
+    }
+    chunks[0].store(new Entry[CHUNK_SIZE], std::memory_order_release);
+}
+
+StringPool::~StringPool() {
+    for (size_t i = 0; i < MAX_CHUNKS; ++i) {
+        delete[] chunks[i].load(std::memory_order_relaxed);
+    }
+}
+
+StringPool& StringPool::getInstance() {
+    static StringPool instance;
+    return instance;
+}
+
+uint32_t StringPool::intern(std::string_view text) {
+    if (text.empty()) {
+        return 0;
+    }
+
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(text);
+        if (it != ids.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    return insertLocked(text);
+}
+
+uint32_t StringPool::insertLocked(std::string_view text) {
+    auto it = ids.find(text);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    uint32_t id = count;
+    size_t chunkIndex = id >> CHUNK_BITS;
+    if (chunkIndex >= MAX_CHUNKS) {
+        throw std::length_error("таблица строк переполнена");
+    }
+
+    Entry* chunk = chunks[chunkIndex].load(std::memory_order_relaxed);
+    if (!chunk) {
+        chunk = new Entry[CHUNK_SIZE];
+        chunks[chunkIndex].store(chunk, std::memory_order_release);
+    }
+
+    Entry& slot = chunk[id & (CHUNK_SIZE - 1)];
+    slot.text.assign(text);
+    slot.folded = id;
+    ids.emplace(std::string_view(slot.text), id);
+    count++;
+
+    // Сложенная строка уже в нижнем регистре, рекурсия не глубже одного шага.
+    std::string folded = CaseFolding::fold(text);
+    if (folded != text) {
+        slot.folded = insertLocked(folded);
+    }
+    return id;
+}
+
+std::optional<uint32_t> StringPool::find(std::string_view text) const {
+    if (text.empty()) {
+        return 0;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(text);
+    if (it == ids.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+size_t StringPool::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return count;
+}
@@ -1,7 +1,4 @@
 #include "../../include/models/task.h"
-#include <ctime>
-#include <sstream>
-#include <iomanip>
 #include <algorithm>
 
 RecurrenceRule::RecurrenceRule(Recurrence oldRecurrence) {
@@ -38,109 +35,93 @@ RecurrenceRule::RecurrenceRule(Recurrence oldRecurrence) {
     }
 }
 
-Task::Task() : id(0), priority(1), completed(false) {
+Task::Task() : id(0), parentId(0), priority(1), completed(false), createdDate(Date::today()) {
     recurrenceRule.type = RecurrenceType::None;
-
-    time_t now = time(nullptr);
-    tm* now_tm = localtime(&now);
-    char buffer[11];
-    strftime(buffer, sizeof(buffer), "%Y-%m-%d", now_tm);
-    createdDate = buffer;
 }
 
-Task::Task(const std::string& description, const std::string& dueDate)
-    : id(0), description(description), dueDate(dueDate), priority(1),
-      completed(false) {
+Task::Task(std::string description, std::string_view dueDate)
+    : id(0), parentId(0), description(std::move(description)), dueDate(Date::parse(dueDate).value_or(Date())), priority(1),
+      completed(false), createdDate(Date::today()) {
     recurrenceRule.type = RecurrenceType::None;
-
-    time_t now = time(nullptr);
-    tm* now_tm = localtime(&now);
-    char buffer[11];
-    strftime(buffer, sizeof(buffer), "%Y-%m-%d", now_tm);
-    createdDate = buffer;
-}
-
-void Task::addTag(const std::string& tag) {
-    if (std::find(tags.begin(), tags.end(), tag) == tags.end()) {
-        tags.push_back(tag);
-    }
 }
 
-void Task::removeTag(const std::string& tag) {
-    tags.erase(std::remove(tags.begin(), tags.end(), tag), tags.end());
+bool Task::hasTag(Symbol tag) const {
+    return std::find(tags.begin(), tags.end(), tag) != tags.end();
 }
 
-void Task::addSubtask(const Task& subtask) {
-    subtasks.push_back(subtask);
+void Task::addTag(std::string_view tag) {
+    Symbol symbol(tag);
+    if (!hasTag(symbol)) {
+        tags.push_back(symbol);
+    }
 }
 
-void Task::removeSubtask(int subtaskId) {
-    subtasks.erase(
-        std::remove_if(
-            subtasks.begin(), 
-            subtasks.end(), 
-            [subtaskId](const Task& t) { return t.getId() == subtaskId; }
-        ), 
-        subtasks.end()
-    );
+void Task::removeTag(std::string_view tag) {
+    auto symbol = Symbol::lookup(tag);
+    if (symbol) {
+        tags.erase(std::remove(tags.begin(), tags.end(), *symbol), tags.end());
+    }
 }
 
-Task* Task::findSubtask(int subtaskId) {
-    for (auto& subtask : subtasks) {
-        if (subtask.getId() == subtaskId) {
-            return &subtask;
-        }
+void Task::patch(unsigned mask, Task&& values) {
+    if (mask & TaskFields::Description) {
+        description = std::move(values.description);
+    }
+    if (mask & TaskFields::DueDate) {
+        dueDate = values.dueDate;
+    }
+    if (mask & TaskFields::Priority) {
+        priority = values.priority;
+    }
+    if (mask & TaskFields::Category) {
+        category = values.category;
+    }
+    if (mask & TaskFields::Completed) {
+        completed = values.completed;
+    }
+    if (mask & TaskFields::Recurrence) {
+        recurrenceRule = std::move(values.recurrenceRule);
+    }
+    if (mask & TaskFields::Notes) {
+        notes = std::move(values.notes);
+    }
+    if (mask & TaskFields::Tags) {
+        tags = std::move(values.tags);
+    }
+    if (mask & TaskFields::ProjectGroup) {
+        projectGroup = values.projectGroup;
     }
-    return nullptr;
 }
 
 bool Task::isOverdue() const {
-    time_t now = time(nullptr);
-    tm* now_tm = localtime(&now);
-    char today[11];
-    strftime(today, sizeof(today), "%Y-%m-%d", now_tm);
-    return dueDate < std::string(today);
+    return dueDate < Date::today();
 }
 
 bool Task::isDueToday() const {
-    time_t now = time(nullptr);
-    tm* now_tm = localtime(&now);
-    char today[11];
-    strftime(today, sizeof(today), "%Y-%m-%d", now_tm);
-    return dueDate == std::string(today);
+    return dueDate == Date::today();
 }
 
-std::string Task::getNextOccurrenceDate() const {
-    if (recurrenceRule.type == RecurrenceType::None) {
+Date Task::getNextOccurrence() const {
+    if (recurrenceRule.type == RecurrenceType::None || !dueDate.isValid()) {
         return dueDate;
     }
 
-    std::tm tm = {};
-    std::istringstream ss(dueDate);
-    ss >> std::get_time(&tm, "%Y-%m-%d");
-
     switch (recurrenceRule.type) {
         case RecurrenceType::Daily:
-            tm.tm_mday += recurrenceRule.interval;
-            break;
+            return dueDate.addDays(recurrenceRule.interval);
         case RecurrenceType::Weekly:
-            tm.tm_mday += 7 * recurrenceRule.interval;
-            break;
+            return dueDate.addDays(7 * recurrenceRule.interval);
         case RecurrenceType::BiWeekly:
-            tm.tm_mday += 14;
-            break;
+            return dueDate.addDays(14);
         case RecurrenceType::Monthly:
-            tm.tm_mon += recurrenceRule.interval;
-            break;
+            return dueDate.addMonths(recurrenceRule.interval);
         case RecurrenceType::Quarterly:
-            tm.tm_mon += 3;
-            break;
+            return dueDate.addMonths(3);
         case RecurrenceType::Yearly:
-            tm.tm_year += recurrenceRule.interval;
-            break;
+            return dueDate.addYears(recurrenceRule.interval);
         case RecurrenceType::Custom:
             if (!recurrenceRule.daysOfWeek.empty()) {
-                int currentDayOfWeek = tm.tm_wday;
+                int currentDayOfWeek = dueDate.weekday();
                 int daysToAdd = 7;
 
                 for (int dayOfWeek : recurrenceRule.daysOfWeek) {
@@ -150,35 +131,15 @@ std::string Task::getNextOccurrenceDate() const {
                     }
                 }
 
-                tm.tm_mday += daysToAdd;
+                return dueDate.addDays(daysToAdd);
             }
-            else if (recurrenceRule.dayOfMonth > 0) {
-                tm.tm_mon += recurrenceRule.interval;
-                tm.tm_mday = recurrenceRule.dayOfMonth;
-
-                int month = tm.tm_mon % 12;
-                int daysInMonth = 31;
-                if (month == 3 || month == 5 || month == 8 || month == 10) {
-                    daysInMonth = 30;
-                } else if (month == 1) {
-                    int year = tm.tm_year + 1900;
-                    bool leapYear = (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0));
-                    daysInMonth = leapYear ? 29 : 28;
-                }
-
-                if (tm.tm_mday > daysInMonth) {
-                    tm.tm_mday = daysInMonth;
-                }
+            if (recurrenceRule.dayOfMonth > 0) {
+                Date::Civil next = dueDate.addMonths(recurrenceRule.interval).civil();
+                int daysInMonth = Date::daysInMonth(next.year, next.month);
+                return Date::fromCivil(next.year, next.month, std::min(recurrenceRule.dayOfMonth, daysInMonth));
             }
-            break;
+            return dueDate;
         default:
             return dueDate;
     }
-    
-    std::time_t time = std::mktime(&tm);
-    tm = *std::localtime(&time);
-    
-    std::ostringstream result;
-    result << std::put_time(&tm, "%Y-%m-%d");
-    return result.str();
 }
@@ -0,0 +1,377 @@
+#include "../../include/models/task_store.h"
+#include "../../include/models/case_folding.h"
+#include <unordered_set>
+
+Task* TaskStore::find(int id) {
+    int slot = slots.find(id);
+    return slot == IdIndex::NOT_FOUND ? nullptr : &tasks[slot];
+}
+
+const Task* TaskStore::find(int id) const {
+    int slot = slots.find(id);
+    return slot == IdIndex::NOT_FOUND ? nullptr : &tasks[slot];
+}
+
+void TaskStore::writeColumns(size_t slot) {
+    const Task& task = tasks[slot];
+    ids[slot] = task.getId();
+    dueDays[slot] = task.getDue().days();
+    priorities[slot] = task.getPriority();
+    completedFlags[slot] = task.isCompleted() ? 1 : 0;
+    categories[slot] = task.getCategorySymbol().getId();
+    groups[slot] = task.getProjectGroupSymbol().getId();
+}
+
+void TaskStore::writeFolded(size_t slot) const {
+    CaseFolding::foldInto(tasks[slot].getDescription(), foldedDescriptions[slot]);
+    CaseFolding::foldInto(tasks[slot].getNotes(), foldedNotes[slot]);
+}
+
+void TaskStore::prepareFolded() const {
+    if (foldedReady) {
+        return;
+    }
+    foldedDescriptions.resize(tasks.size());
+    foldedNotes.resize(tasks.size());
+    for (size_t slot = 0; slot < tasks.size(); ++slot) {
+        writeFolded(slot);
+    }
+    foldedReady = true;
+}
+
+void TaskStore::dropFolded() {
+    foldedDescriptions.clear();
+    foldedNotes.clear();
+    foldedReady = false;
+}
+
+void TaskStore::rebuildColumns() {
+    const size_t count = tasks.size();
+    ids.resize(count);
+    dueDays.resize(count);
+    priorities.resize(count);
+    completedFlags.resize(count);
+    categories.resize(count);
+    groups.resize(count);
+
+    slots.clear();
+    slots.reserve(count);
+    for (size_t slot = 0; slot < count; ++slot) {
+        writeColumns(slot);
+        slots.insert(ids[slot], static_cast<int>(slot));
+    }
+
+    relink();
+    if (detachCycles()) {
+        relink();
+    }
+}
+
+void TaskStore::relink() {
+    const size_t count = tasks.size();
+    parents.assign(count, NO_SLOT);
+    firstChildren.assign(count, NO_SLOT);
+    nextSiblings.assign(count, NO_SLOT);
+
+    std::vector<int> lastChildren(count, NO_SLOT);
+    for (size_t slot = 0; slot < count; ++slot) {
+        int parentId = tasks[slot].getParentId();
+        if (parentId == 0) {
+            continue;
+        }
+
+        int parent = slots.find(parentId);
+        if (parent == IdIndex::NOT_FOUND || parent == static_cast<int>(slot)) {
+            tasks[slot].setParentId(0);
+            continue;
+        }
+
+        parents[slot] = parent;
+        if (lastChildren[parent] == NO_SLOT) {
+            firstChildren[parent] = static_cast<int>(slot);
+        } else {
+            nextSiblings[lastChildren[parent]] = static_cast<int>(slot);
+        }
+        lastChildren[parent] = static_cast<int>(slot);
+    }
+}
+
+// Задачи, недостижимые от задач верхнего уровня, замкнуты в цикл по parentId.
+bool TaskStore::detachCycles() {
+    std::vector<uint8_t> reached(tasks.size(), 0);
+    for (size_t slot = 0; slot < tasks.size(); ++slot) {
+        if (parents[slot] == NO_SLOT) {
+            reached[slot] = 1;
+            forEachDescendant(slot, [&](const Task& task, int) { reached[slots.find(task.getId())] = 1; });
+        }
+    }
+
+    bool detached = false;
+    for (size_t slot = 0; slot < tasks.size(); ++slot) {
+        if (!reached[slot]) {
+            tasks[slot].setParentId(0);
+            detached = true;
+        }
+    }
+    return detached;
+}
+
+// Ставит задачу в список детей родителя по порядку хранения. Отсутствующий
+// родитель и ссылка, замыкающая цикл, обнуляются.
+void TaskStore::linkChild(size_t slot) {
+    int parentId = tasks[slot].getParentId();
+    int parent = parentId == 0 ? IdIndex::NOT_FOUND : slots.find(parentId);
+    for (int ancestor = parent; ancestor != NO_SLOT; ancestor = parents[ancestor]) {
+        if (ancestor == static_cast<int>(slot)) {
+            parent = IdIndex::NOT_FOUND;
+            break;
+        }
+    }
+    if (parent == IdIndex::NOT_FOUND) {
+        tasks[slot].setParentId(0);
+        return;
+    }
+
+    parents[slot] = parent;
+    const int child = static_cast<int>(slot);
+    if (firstChildren[parent] == NO_SLOT || firstChildren[parent] > child) {
+        nextSiblings[slot] = firstChildren[parent];
+        firstChildren[parent] = child;
+        return;
+    }
+
+    int previous = firstChildren[parent];
+    while (nextSiblings[previous] != NO_SLOT && nextSiblings[previous] < child) {
+        previous = nextSiblings[previous];
+    }
+    nextSiblings[slot] = nextSiblings[previous];
+    nextSiblings[previous] = child;
+}
+
+void TaskStore::unlinkChild(size_t slot) {
+    const int parent = parents[slot];
+    if (parent == NO_SLOT) {
+        return;
+    }
+
+    const int child = static_cast<int>(slot);
+    if (firstChildren[parent] == child) {
+        firstChildren[parent] = nextSiblings[slot];
+    } else {
+        int previous = firstChildren[parent];
+        while (nextSiblings[previous] != child) {
+            previous = nextSiblings[previous];
+        }
+        nextSiblings[previous] = nextSiblings[slot];
+    }
+    parents[slot] = NO_SLOT;
+    nextSiblings[slot] = NO_SLOT;
+}
+
+// Подзадачи становятся задачами верхнего уровня, как при перестроении,
+// когда родителя с их parentId больше нет.
+void TaskStore::detachChildren(size_t slot) {
+    int child = firstChildren[slot];
+    while (child != NO_SLOT) {
+        int next = nextSiblings[child];
+        tasks[child].setParentId(0);
+        parents[child] = NO_SLOT;
+        nextSiblings[child] = NO_SLOT;
+        child = next;
+    }
+    firstChildren[slot] = NO_SLOT;
+}
+
+std::vector<Task> TaskStore::release() {
+    std::vector<Task> released = std::move(tasks);
+    tasks.clear();
+    dropFolded();
+    rebuildColumns();
+    return released;
+}
+
+void TaskStore::assign(std::vector<Task>&& loaded) {
+    tasks = std::move(loaded);
+    dropFolded();
+    rebuildColumns();
+}
+
+Task& TaskStore::push_back(Task task) {
+    tasks.push_back(std::move(task));
+    ids.push_back(0);
+    dueDays.push_back(0);
+    priorities.push_back(0);
+    completedFlags.push_back(0);
+    categories.push_back(0);
+    groups.push_back(0);
+    parents.push_back(NO_SLOT);
+    firstChildren.push_back(NO_SLOT);
+    nextSiblings.push_back(NO_SLOT);
+    if (foldedReady) {
+        foldedDescriptions.emplace_back();
+        foldedNotes.emplace_back();
+    }
+
+    const size_t slot = tasks.size() - 1;
+    writeColumns(slot);
+    if (foldedReady) {
+        writeFolded(slot);
+    }
+    slots.assign(ids[slot], static_cast<int>(slot));
+    linkChild(slot);
+    return tasks[slot];
+}
+
+// Удаленные ID убираются из индекса, а задачи после первой удаленной позиции
+// сдвигаются вместе со столбцами; позиции в индексе пересчитываются одним
+// проходом по таблице. Ссылки иерархии меняются только у сдвинутых задач и у
+// их соседей перед удаленным диапазоном.
+std::vector<int> TaskStore::erase(size_t slot) {
+    std::vector<int> removedIds{ids[slot]};
+    std::vector<int> removedSlots{static_cast<int>(slot)};
+    forEachDescendant(slot, [&](const Task& task, int) {
+        removedIds.push_back(task.getId());
+        removedSlots.push_back(slots.find(task.getId()));
+    });
+    std::sort(removedSlots.begin(), removedSlots.end());
+    for (int id : removedIds) {
+        slots.erase(id);
+    }
+    unlinkChild(slot);
+
+    const size_t count = tasks.size();
+    const size_t first = static_cast<size_t>(removedSlots.front());
+    std::vector<int> shifted(count - first, NO_SLOT);
+    size_t kept = first;
+    for (size_t i = first, removed = 0; i < count; ++i) {
+        if (removed < removedSlots.size() && removedSlots[removed] == static_cast<int>(i)) {
+            removed++;
+        } else {
+            shifted[i - first] = static_cast<int>(kept++);
+        }
+    }
+    auto remap = [&](int link) { return link < static_cast<int>(first) ? link : shifted[link - first]; };
+
+    // Ссылки задач до first на сдвигаемые: родитель (первый ребенок), подзадачи
+    // и предыдущий брат. Собираются по старым позициям и применяются после.
+    struct FixUp {
+        std::vector<int>* column;
+        size_t slot;
+        int value;
+    };
+    std::vector<FixUp> fixUps;
+    std::unordered_set<int> visitedParents;
+    for (size_t i = first; i < count; ++i) {
+        const int target = shifted[i - first];
+        if (target == NO_SLOT) {
+            continue;
+        }
+
+        for (int child = firstChildren[i]; child != NO_SLOT; child = nextSiblings[child]) {
+            if (child < static_cast<int>(first)) {
+                fixUps.push_back({&parents, static_cast<size_t>(child), target});
+            }
+        }
+
+        const int parent = parents[i];
+        if (parent == NO_SLOT) {
+            continue;
+        }
+        if (parent < static_cast<int>(first) && firstChildren[parent] == static_cast<int>(i)) {
+            fixUps.push_back({&firstChildren, static_cast<size_t>(parent), target});
+        }
+        if (firstChildren[parent] >= static_cast<int>(first) || !visitedParents.insert(parent).second) {
+            continue;
+        }
+        int previous = firstChildren[parent];
+        while (nextSiblings[previous] != NO_SLOT && nextSiblings[previous] < static_cast<int>(first)) {
+            previous = nextSiblings[previous];
+        }
+        if (nextSiblings[previous] == static_cast<int>(i)) {
+            fixUps.push_back({&nextSiblings, static_cast<size_t>(previous), target});
+        }
+    }
+    for (const auto& fixUp : fixUps) {
+        (*fixUp.column)[fixUp.slot] = fixUp.value;
+    }
+
+    for (size_t i = first; i < count; ++i) {
+        const int target = shifted[i - first];
+        if (target == NO_SLOT) {
+            continue;
+        }
+        if (target != static_cast<int>(i)) {
+            tasks[target] = std::move(tasks[i]);
+            ids[target] = ids[i];
+            dueDays[target] = dueDays[i];
+            priorities[target] = priorities[i];
+            completedFlags[target] = completedFlags[i];
+            categories[target] = categories[i];
+            groups[target] = groups[i];
+            if (foldedReady) {
+                foldedDescriptions[target] = std::move(foldedDescriptions[i]);
+                foldedNotes[target] = std::move(foldedNotes[i]);
+            }
+        }
+        parents[target] = remap(parents[i]);
+        firstChildren[target] = remap(firstChildren[i]);
+        nextSiblings[target] = remap(nextSiblings[i]);
+    }
+
+    slots.remapValues(remap);
+
+    tasks.resize(kept);
+    ids.resize(kept);
+    dueDays.resize(kept);
+    priorities.resize(kept);
+    completedFlags.resize(kept);
+    categories.resize(kept);
+    groups.resize(kept);
+    parents.resize(kept);
+    firstChildren.resize(kept);
+    nextSiblings.resize(kept);
+    if (foldedReady) {
+        foldedDescriptions.resize(kept);
+        foldedNotes.resize(kept);
+    }
+    return removedIds;
+}
+
+void TaskStore::refresh(size_t slot) {
+    const int previousId = ids[slot];
+    const int previousParent = parents[slot] == NO_SLOT ? 0 : ids[parents[slot]];
+    writeColumns(slot);
+    if (foldedReady) {
+        writeFolded(slot);
+    }
+
+    if (ids[slot] != previousId) {
+        if (slots.find(previousId) == static_cast<int>(slot)) {
+            slots.erase(previousId);
+        }
+        slots.assign(ids[slot], static_cast<int>(slot));
+        detachChildren(slot);
+    }
+    if (tasks[slot].getParentId() != previousParent) {
+        unlinkChild(slot);
+        linkChild(slot);
+    }
+}
+
+void TaskStore::clear() {
+    tasks.clear();
+    dropFolded();
+    rebuildColumns();
+}
+
+void TaskStore::sortBy(const SortSpec& spec) {
+    std::vector<uint32_t> order = spec.order(tasks);
+    std::vector<Task> sorted;
+    sorted.reserve(tasks.size());
+    for (uint32_t slot : order) {
+        sorted.push_back(std::move(tasks[slot]));
+    }
+    tasks = std::move(sorted);
+    dropFolded();
+    rebuildColumns();
+}
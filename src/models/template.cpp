@@ -4,12 +4,12 @@
 TaskTemplate::TaskTemplate() : priority(1), recurrence(Recurrence::None) {
 }
 
-TaskTemplate::TaskTemplate(const std::string& name, const std::string& description) 
-    : name(name), description(description), priority(1), recurrence(Recurrence::None) {
+TaskTemplate::TaskTemplate(std::string name, std::string description)
+    : name(std::move(name)), description(std::move(description)), priority(1), recurrence(Recurrence::None) {
 }
 
-void TaskTemplate::addSubtaskDescription(const std::string& description) {
-    subtaskDescriptions.push_back(description);
+void TaskTemplate::addSubtaskDescription(std::string description) {
+    subtaskDescriptions.push_back(std::move(description));
 }
 
 void TaskTemplate::removeSubtaskDescription(int index) {
@@ -23,33 +23,30 @@ Task TaskTemplate::createTask(const std::string& dueDate) const {
     task.setDescription(description);
     task.setDueDate(dueDate);
     task.setPriority(priority);
-    task.setCategory(category);
+    task.setCategorySymbol(category);
     task.setCompleted(false);
     task.setRecurrence(recurrence);
     task.setNotes(notes);
-    task.setProjectGroup(projectGroup);
-    task.setTags(tags);
+    task.setProjectGroupSymbol(projectGroup);
+    task.setTagSymbols(tags);
 
-    std::time_t now = std::time(nullptr);
-    std::tm* now_tm = std::localtime(&now);
-    char buffer[11];
-    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d", now_tm);
-    task.setCreatedDate(buffer);
+    task.setCreated(Date::today());
+    return task;
+}
 
-    int subtaskIdCounter = 1;
+std::vector<Task> TaskTemplate::createSubtasks(const Task& task) const {
+    std::vector<Task> subtasks;
+    subtasks.reserve(subtaskDescriptions.size());
     for (const auto& subtaskDesc : subtaskDescriptions) {
         Task subtask;
         subtask.setDescription(subtaskDesc);
-        subtask.setDueDate(dueDate);
+        subtask.setDue(task.getDue());
         subtask.setPriority(priority);
-        subtask.setCategory(category);
+        subtask.setCategorySymbol(category);
         subtask.setCompleted(false);
         subtask.setRecurrence(Recurrence::None);
-        subtask.setCreatedDate(buffer);
-
-        task.addSubtask(subtask);
-        subtaskIdCounter++;
+        subtask.setCreated(task.getCreated());
+        subtasks.push_back(std::move(subtask));
     }
-    
-    return task;
-}
\ No newline at end of file
+    return subtasks;
+}
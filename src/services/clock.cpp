@@ -0,0 +1,90 @@
+#include "../../include/services/clock.h"
+#include <atomic>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+
+namespace {
+    std::atomic<bool> hasSource{false};
+    std::mutex sourceMutex;
+    Clock::Source source;
+
+    int64_t toSeconds(Clock::TimePoint time) {
+        return std::chrono::floor<std::chrono::seconds>(time.time_since_epoch()).count();
+    }
+}
+
+Clock::TimePoint Clock::now() {
+    if (!hasSource.load(std::memory_order_acquire)) {
+        return std::chrono::system_clock::now();
+    }
+
+    std::lock_guard<std::mutex> lock(sourceMutex);
+    return source ? source() : std::chrono::system_clock::now();
+}
+
+Date Clock::today() {
+    return localMinute(now()).day;
+}
+
+std::string Clock::todayString() {
+    return localMinute(now()).day.toString();
+}
+
+const Clock::LocalMinute& Clock::localMinute(TimePoint time) {
+    thread_local LocalMinute cached;
+    thread_local bool filled = false;
+
+    const int64_t seconds = toSeconds(time);
+    if (filled && seconds >= cached.start && seconds < cached.start + 60) {
+        return cached;
+    }
+
+    std::time_t timeT = static_cast<std::time_t>(seconds);
+    std::tm local {};
+#ifdef _WIN32
+    localtime_s(&local, &timeT);
+#else
+    localtime_r(&timeT, &local);
+#endif
+
+    // tm_sec = 60 бывает только на секунде координации, минута при этом та же.
+    const int second = local.tm_sec < 60 ? local.tm_sec : 59;
+    cached.start = seconds - second;
+    cached.day = Date::fromCivil(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+    cached.hour = local.tm_hour;
+    cached.minute = local.tm_min;
+    std::snprintf(cached.text, sizeof(cached.text), "%04d-%02d-%02d %02d:%02d",
+                  local.tm_year + 1900, local.tm_mon + 1, local.tm_mday, local.tm_hour, local.tm_min);
+    filled = true;
+    return cached;
+}
+
+std::string Clock::formatMinute(TimePoint time) {
+    return localMinute(time).text;
+}
+
+std::string Clock::formatMillis(TimePoint time) {
+    const LocalMinute& minute = localMinute(time);
+    const int64_t millis = std::chrono::floor<std::chrono::milliseconds>(time.time_since_epoch()).count();
+    const int second = static_cast<int>(toSeconds(time) - minute.start);
+
+    char buffer[sizeof(LocalMinute::text) + 24];
+    std::snprintf(buffer, sizeof(buffer), "%s:%02d.%03d", minute.text, second,
+                  static_cast<int>(millis - toSeconds(time) * 1000));
+    return buffer;
+}
+
+void Clock::setSource(Source newSource) {
+    std::lock_guard<std::mutex> lock(sourceMutex);
+    source = std::move(newSource);
+    hasSource.store(static_cast<bool>(source), std::memory_order_release);
+}
+
+void Clock::resetSource() {
+    setSource(nullptr);
+}
+
+void Clock::freeze(TimePoint time) {
+    setSource([time] { return time; });
+}
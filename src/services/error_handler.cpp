@@ -6,6 +6,7 @@
 #include <sstream>
 #include <iomanip>
 #include "../../include/services/logger.h"
+#include "../../include/services/clock.h"
 
 void ErrorHandler::executeWithErrorHandling(std::function<void()> operation, 
                                         const std::string& errorMessage, 
@@ -45,14 +46,10 @@ void ErrorHandler::logError(const std::string& errorMessage, ErrorType errorType
 
     std::ofstream logFile("todolist_errors.log", std::ios::app);
     if (logFile.is_open()) {
-        auto now = std::chrono::system_clock::now();
-        auto now_time_t = std::chrono::system_clock::to_time_t(now);
-        std::tm* now_tm = std::localtime(&now_time_t);
+        std::string timeStr = Clock::formatMillis(Clock::now());
+        timeStr.resize(19);
 
-        std::stringstream timeStr;
-        timeStr << std::put_time(now_tm, "%Y-%m-%d %H:%M:%S");
-
-        logFile << "[" << timeStr.str() << "] " << formattedError << std::endl;
+        logFile << "[" << timeStr << "] " << formattedError << std::endl;
         logFile.close();
     }
 }
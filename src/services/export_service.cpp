@@ -1,14 +1,19 @@
 #include "../../include/services/export_service.h"
 #include "../../include/services/logger.h"
+#include "../../include/services/clock.h"
 #include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 #include <nlohmann/json.hpp>
+#include "../../include/services/schema_codec.h"
 
 using json = nlohmann::json;
 
-bool ExportService::exportToMarkdown(const std::vector<Task>& tasks, const std::string& filename) {
+bool ExportService::exportToMarkdown(const TaskStore& tasks, const std::string& filename) {
     Logger::getInstance().info("Начало экспорта в Markdown: " + filename);
 
     try {
@@ -23,10 +28,10 @@ bool ExportService::exportToMarkdown(const std::vector<Task>& tasks, const std::
         file << "Дата экспорта: " << getCurrentDate() << "\n\n";
 
         std::map<std::string, std::vector<const Task*>> tasksByCategory;
-        for (const auto& task : tasks) {
+        tasks.forEachRoot([&](const Task& task) {
             std::string category = task.getCategory().empty() ? "Без категории" : task.getCategory();
             tasksByCategory[category].push_back(&task);
-        }
+        });
 
         for (const auto& [category, categoryTasks] : tasksByCategory) {
             file << "## " << category << "\n\n";
@@ -70,20 +75,22 @@ bool ExportService::exportToMarkdown(const std::vector<Task>& tasks, const std::
                     file << "- **Повторение:** " << recurrenceType << "\n";
                 }
 
-                if (!task->getSubtasks().empty()) {
+                int slot = tasks.slotOf(task->getId());
+                if (tasks.firstChildOf(slot) != TaskStore::NO_SLOT) {
                     file << "\n#### Подзадачи:\n\n";
 
-                    for (const auto& subtask : task->getSubtasks()) {
-                        file << "- **#" << subtask.getId() << ":** " << subtask.getDescription()
+                    tasks.forEachDescendant(slot, [&](const Task& subtask, int depth) {
+                        std::string indent(static_cast<size_t>(depth - 1) * 2, ' ');
+                        file << indent << "- **#" << subtask.getId() << ":** " << subtask.getDescription()
                              << " (" << (subtask.isCompleted() ? "✅" : "⏳") << ")\n";
-                        file << "  - Срок: " << subtask.getDueDate() << ", Приоритет: " << subtask.getPriority() << "\n";
+                        file << indent << "  - Срок: " << subtask.getDueDate() << ", Приоритет: " << subtask.getPriority() << "\n";
 
                         if (!subtask.getNotes().empty()) {
-                            file << "  - Заметки: " << subtask.getNotes() << "\n";
+                            file << indent << "  - Заметки: " << subtask.getNotes() << "\n";
                         }
 
                         if (!subtask.getTags().empty()) {
-                            file << "  - Теги: ";
+                            file << indent << "  - Теги: ";
                             for (size_t i = 0; i < subtask.getTags().size(); ++i) {
                                 file << "`" << subtask.getTags()[i] << "`";
                                 if (i + 1 < subtask.getTags().size()) {
@@ -92,7 +99,7 @@ bool ExportService::exportToMarkdown(const std::vector<Task>& tasks, const std::
                             }
                             file << "\n";
                         }
-                    }
+                    });
                 }
 
                 file << "\n";
@@ -120,7 +127,73 @@ std::string ExportService::convertDateToICS(const std::string& date) {
     return result;
 }
 
-bool ExportService::exportToICS(const std::vector<Task>& tasks, const std::string& filename) {
+// RFC 5545 не допускает UNTIL и COUNT в одном правиле, поэтому при заданной
+// дате окончания число повторений не выводится.
+std::string ExportService::buildRRule(const RecurrenceRule& rule) {
+    static const char* const weekdays[] = {"SU", "MO", "TU", "WE", "TH", "FR", "SA"};
+
+    std::string frequency;
+    int interval = rule.interval;
+    switch (rule.type) {
+        case RecurrenceType::None:
+            return "";
+        case RecurrenceType::Daily: frequency = "DAILY"; break;
+        case RecurrenceType::Weekly: frequency = "WEEKLY"; break;
+        case RecurrenceType::BiWeekly: frequency = "WEEKLY"; interval = 2; break;
+        case RecurrenceType::Monthly: frequency = "MONTHLY"; break;
+        case RecurrenceType::Quarterly: frequency = "MONTHLY"; interval = 3; break;
+        case RecurrenceType::Yearly: frequency = "YEARLY"; break;
+        case RecurrenceType::Custom:
+            if (rule.monthOfYear > 0) {
+                frequency = "YEARLY";
+            } else if (rule.dayOfMonth > 0 || rule.weekOfMonth != 0) {
+                frequency = "MONTHLY";
+            } else if (!rule.daysOfWeek.empty()) {
+                frequency = "WEEKLY";
+            } else {
+                frequency = "DAILY";
+            }
+            break;
+    }
+
+    std::string result = "FREQ=" + frequency;
+    if (interval > 1) {
+        result += ";INTERVAL=" + std::to_string(interval);
+    }
+
+    std::string byDay;
+    for (int day : rule.daysOfWeek) {
+        if (day < 0 || day > 6) {
+            continue;
+        }
+        if (!byDay.empty()) {
+            byDay += ",";
+        }
+        if (rule.weekOfMonth != 0 && frequency != "WEEKLY") {
+            byDay += std::to_string(rule.weekOfMonth);
+        }
+        byDay += weekdays[day];
+    }
+    if (!byDay.empty()) {
+        result += ";BYDAY=" + byDay;
+    }
+
+    if (rule.dayOfMonth > 0 && frequency != "WEEKLY" && frequency != "DAILY") {
+        result += ";BYMONTHDAY=" + std::to_string(rule.dayOfMonth);
+    }
+    if (rule.monthOfYear >= 1 && rule.monthOfYear <= 12 && frequency == "YEARLY") {
+        result += ";BYMONTH=" + std::to_string(rule.monthOfYear);
+    }
+
+    if (!rule.endDate.empty()) {
+        result += ";UNTIL=" + convertDateToICS(rule.endDate);
+    } else if (rule.maxOccurrences > 0) {
+        result += ";COUNT=" + std::to_string(rule.maxOccurrences);
+    }
+    return result;
+}
+
+bool ExportService::exportToICS(const TaskStore& tasks, const std::string& filename) {
     Logger::getInstance().info("Начало экспорта в iCalendar (ICS): " + filename);
 
     try {
@@ -137,7 +210,7 @@ bool ExportService::exportToICS(const std::vector<Task>& tasks, const std::strin
         file << "CALSCALE:GREGORIAN\r\n";
         file << "METHOD:PUBLISH\r\n";
 
-        auto now = std::chrono::system_clock::now();
+        auto now = Clock::now();
         auto now_time_t = std::chrono::system_clock::to_time_t(now);
         std::tm* now_tm = std::localtime(&now_time_t);
 
@@ -146,7 +219,7 @@ bool ExportService::exportToICS(const std::vector<Task>& tasks, const std::strin
 
         int eventCount = 0;
 
-        for (const auto& task : tasks) {
+        tasks.forEachRoot([&](const Task& task) {
             file << "BEGIN:VEVENT\r\n";
 
             file << "UID:task-" << task.getId() << "@todolist\r\n";
@@ -180,46 +253,25 @@ bool ExportService::exportToICS(const std::vector<Task>& tasks, const std::strin
 
             file << "STATUS:" << (task.isCompleted() ? "COMPLETED" : "NEEDS-ACTION") << "\r\n";
 
-            if (task.getRecurrence() != Recurrence::None) {
-                file << "RRULE:FREQ=";
-
-                switch (task.getRecurrence()) {
-                    case Recurrence::Daily:
-                        file << "DAILY";
-                        break;
-                    case Recurrence::Weekly:
-                        file << "WEEKLY";
-                        break;
-                    case Recurrence::BiWeekly:
-                        file << "WEEKLY;INTERVAL=2";
-                        break;
-                    case Recurrence::Monthly:
-                        file << "MONTHLY";
-                        break;
-                    case Recurrence::Quarterly:
-                        file << "MONTHLY;INTERVAL=3";
-                        break;
-                    case Recurrence::Yearly:
-                        file << "YEARLY";
-                        break;
-                    default:
-                        break;
-                }
-
-                file << "\r\n";
+            std::string rrule = buildRRule(task.getRecurrenceRule());
+            if (!rrule.empty()) {
+                file << "RRULE:" << rrule << "\r\n";
             }
 
             file << "END:VEVENT\r\n";
             eventCount++;
 
-            for (const auto& subtask : task.getSubtasks()) {
+            tasks.forEachDescendant(tasks.slotOf(task.getId()), [&](const Task& subtask, int) {
+                const Task& parent = tasks[tasks.slotOf(subtask.getParentId())];
+                std::string parentUid = (parent.isSubtask() ? "subtask-" : "task-") + std::to_string(parent.getId());
+
                 file << "BEGIN:VEVENT\r\n";
                 file << "UID:subtask-" << subtask.getId() << "@todolist\r\n";
                 file << "DTSTAMP:" << timestamp << "\r\n";
                 file << "DTSTART;VALUE=DATE:" << convertDateToICS(subtask.getDueDate()) << "\r\n";
                 file << "SUMMARY:[Подзадача] " << subtask.getDescription() << "\r\n";
-                file << "DESCRIPTION:Subtask of task #" << task.getId() << ": "
-                     << task.getDescription() << "\\n\\nPriority: " << subtask.getPriority();
+                file << "DESCRIPTION:Subtask of task #" << parent.getId() << ": "
+                     << parent.getDescription() << "\\n\\nPriority: " << subtask.getPriority();
 
                 if (!subtask.getNotes().empty()) {
                     file << "\\n\\nNotes: " << subtask.getNotes();
@@ -227,11 +279,16 @@ bool ExportService::exportToICS(const std::vector<Task>& tasks, const std::strin
 
                 file << "\r\n";
                 file << "STATUS:" << (subtask.isCompleted() ? "COMPLETED" : "NEEDS-ACTION") << "\r\n";
-                file << "RELATED-TO:task-" << task.getId() << "@todolist\r\n";
+                file << "RELATED-TO:" << parentUid << "@todolist\r\n";
+
+                std::string subtaskRRule = buildRRule(subtask.getRecurrenceRule());
+                if (!subtaskRRule.empty()) {
+                    file << "RRULE:" << subtaskRRule << "\r\n";
+                }
                 file << "END:VEVENT\r\n";
                 eventCount++;
-            }
-        }
+            });
+        });
 
         file << "END:VCALENDAR\r\n";
         file.close();
@@ -246,7 +303,7 @@ bool ExportService::exportToICS(const std::vector<Task>& tasks, const std::strin
     }
 }
 
-bool ExportService::exportToCSV(const std::vector<Task>& tasks, const std::string& filename) {
+bool ExportService::exportToCSV(const TaskStore& tasks, const std::string& filename) {
     Logger::getInstance().info("Начало экспорта в CSV: " + filename);
 
     try {
@@ -257,51 +314,29 @@ bool ExportService::exportToCSV(const std::vector<Task>& tasks, const std::strin
             return false;
         }
 
-        file << "ID,Описание,Дата,Приоритет,Категория,Статус,Примечания,Теги,Группа проекта,Родительская задача\n";
+        std::vector<std::string> cells;
+        Schema::csvHeader<Task>(cells);
+        cells.push_back(CSV_PARENT_COLUMN);
+        writeCSVRow(file, cells);
 
         int taskCount = 0;
         int subtaskCount = 0;
 
-        for (const auto& task : tasks) {
-            file << task.getId() << ","
-                 << "\"" << escapeCSV(task.getDescription()) << "\","
-                 << task.getDueDate() << ","
-                 << task.getPriority() << ","
-                 << "\"" << escapeCSV(task.getCategory()) << "\","
-                 << (task.isCompleted() ? "Выполнена" : "Не выполнена") << ","
-                 << "\"" << escapeCSV(task.getNotes()) << "\",";
-
-            file << "\"";
-            for (size_t i = 0; i < task.getTags().size(); ++i) {
-                file << escapeCSV(task.getTags()[i]);
-                if (i + 1 < task.getTags().size()) file << ";";
-            }
-            file << "\",";
-
-            file << "\"" << escapeCSV(task.getProjectGroup()) << "\",\n";
+        tasks.forEachRoot([&](const Task& task) {
+            cells.clear();
+            Schema::csvRow(task, cells);
+            cells.emplace_back();
+            writeCSVRow(file, cells);
             taskCount++;
 
-            for (const auto& subtask : task.getSubtasks()) {
-                file << subtask.getId() << ","
-                     << "\"" << escapeCSV(subtask.getDescription()) << "\","
-                     << subtask.getDueDate() << ","
-                     << subtask.getPriority() << ","
-                     << "\"" << escapeCSV(subtask.getCategory()) << "\","
-                     << (subtask.isCompleted() ? "Выполнена" : "Не выполнена") << ","
-                     << "\"" << escapeCSV(subtask.getNotes()) << "\",";
-
-                file << "\"";
-                for (size_t i = 0; i < subtask.getTags().size(); ++i) {
-                    file << escapeCSV(subtask.getTags()[i]);
-                    if (i + 1 < subtask.getTags().size()) file << ";";
-                }
-                file << "\",";
-
-                file << "\"\","
-                     << task.getId() << "\n";
+            tasks.forEachDescendant(tasks.slotOf(task.getId()), [&](const Task& subtask, int) {
+                cells.clear();
+                Schema::csvRow(subtask, cells);
+                cells.push_back(std::to_string(subtask.getParentId()));
+                writeCSVRow(file, cells);
                 subtaskCount++;
-            }
-        }
+            });
+        });
 
         file.close();
         Logger::getInstance().info("Экспорт в CSV успешно завершен: " + filename +
@@ -315,7 +350,66 @@ bool ExportService::exportToCSV(const std::vector<Task>& tasks, const std::strin
     }
 }
 
-bool ExportService::exportToHTML(const std::vector<Task>& tasks, const std::string& filename) {
+bool ExportService::importFromCSV(const std::string& filename, std::vector<Task>& tasks) {
+    Logger::getInstance().info("Начало импорта задач из CSV: " + filename);
+
+    try {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            Logger::getInstance().error("Не удалось открыть файл для импорта из CSV: " + filename);
+            std::cerr << "Не удалось открыть файл для импорта из CSV: " << filename << std::endl;
+            return false;
+        }
+
+        std::vector<std::string> cells;
+        if (!readCSVRow(file, cells)) {
+            Logger::getInstance().error("Файл CSV пуст: " + filename);
+            return false;
+        }
+
+        std::unordered_map<std::string, size_t> columns;
+        for (size_t i = 0; i < cells.size(); ++i) {
+            columns[cells[i]] = i;
+        }
+        auto parentColumn = columns.find(CSV_PARENT_COLUMN);
+
+        std::vector<Task> imported;
+        std::unordered_set<int> importedIds;
+        int errorCount = 0;
+        while (readCSVRow(file, cells)) {
+            Task task;
+            Schema::csvAssign(task, columns, cells);
+
+            int64_t parentId = 0;
+            if (parentColumn != columns.end() && parentColumn->second < cells.size() &&
+                !cells[parentColumn->second].empty()) {
+                if (!Schema::parseInteger(cells[parentColumn->second], parentId) ||
+                    importedIds.count(static_cast<int>(parentId)) == 0) {
+                    errorCount++;
+                    Logger::getInstance().warning("Не найдена родительская задача для подзадачи #" +
+                                                  std::to_string(task.getId()));
+                    continue;
+                }
+            }
+
+            task.setParentId(static_cast<int>(parentId));
+            importedIds.insert(task.getId());
+            imported.push_back(std::move(task));
+        }
+
+        tasks.insert(tasks.end(), std::make_move_iterator(imported.begin()), std::make_move_iterator(imported.end()));
+        Logger::getInstance().info("Импорт из CSV завершен: " + filename + ". Импортировано " +
+                                 std::to_string(imported.size()) + " задач, с ошибками " +
+                                 std::to_string(errorCount));
+        return true;
+    } catch (const std::exception& e) {
+        Logger::getInstance().error("Ошибка при импорте из CSV: " + std::string(e.what()));
+        std::cerr << "Ошибка при импорте из CSV: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool ExportService::exportToHTML(const TaskStore& tasks, const std::string& filename) {
     Logger::getInstance().info("Начало экспорта в HTML: " + filename);
 
     try {
@@ -357,10 +451,10 @@ bool ExportService::exportToHTML(const std::vector<Task>& tasks, const std::stri
              << "    <p>Дата экспорта: " << getCurrentDate() << "</p>\n";
 
         std::map<std::string, std::vector<const Task*>> tasksByCategory;
-        for (const auto& task : tasks) {
+        tasks.forEachRoot([&](const Task& task) {
             std::string category = task.getCategory().empty() ? "Без категории" : task.getCategory();
             tasksByCategory[category].push_back(&task);
-        }
+        });
 
         file << "    <div class=\"categories\">\n"
              << "        <h2>Категории:</h2>\n"
@@ -435,11 +529,12 @@ bool ExportService::exportToHTML(const std::vector<Task>& tasks, const std::stri
                     file << "\n            </div>\n";
                 }
 
-                if (!task->getSubtasks().empty()) {
+                int slot = tasks.slotOf(task->getId());
+                if (tasks.firstChildOf(slot) != TaskStore::NO_SLOT) {
                     file << "            <div class=\"subtasks\">\n"
                          << "                <h3>Подзадачи:</h3>\n";
 
-                    for (const auto& subtask : task->getSubtasks()) {
+                    tasks.forEachDescendant(slot, [&](const Task& subtask, int depth) {
                         std::string subtaskClass = "subtask priority-" + std::to_string(subtask.getPriority());
                         if (subtask.isCompleted()) {
                             subtaskClass += " task-completed";
@@ -447,7 +542,11 @@ bool ExportService::exportToHTML(const std::vector<Task>& tasks, const std::stri
                             subtaskClass += " task-overdue";
                         }
 
-                        file << "                <div class=\"" << subtaskClass << "\">\n"
+                        file << "                <div class=\"" << subtaskClass << "\"";
+                        if (depth > 1) {
+                            file << " style=\"margin-left: " << 30 * depth << "px;\"";
+                        }
+                        file << ">\n"
                              << "                    <h4>#" << subtask.getId() << ": " << subtask.getDescription() << "</h4>\n"
                              << "                    <div class=\"task-info\">\n"
                              << "                        <div>Срок: " << subtask.getDueDate() << "</div>\n"
@@ -475,7 +574,7 @@ bool ExportService::exportToHTML(const std::vector<Task>& tasks, const std::stri
 
                         file << "                </div>\n";
                         subtaskCount++;
-                    }
+                    });
 
                     file << "            </div>\n";
                 }
@@ -524,28 +623,7 @@ bool ExportService::exportTemplates(const std::map<std::string, TaskTemplate>& t
         json templatesJson = json::array();
 
         for (const auto& [name, templ] : templates) {
-            json templateJson;
-            templateJson["name"] = templ.getName();
-            templateJson["description"] = templ.getDescription();
-            templateJson["category"] = templ.getCategory();
-            templateJson["priority"] = templ.getPriority();
-            templateJson["recurrence"] = static_cast<int>(templ.getRecurrence());
-            templateJson["notes"] = templ.getNotes();
-            templateJson["projectGroup"] = templ.getProjectGroup();
-
-            json subtaskDescJson = json::array();
-            for (const auto& desc : templ.getSubtaskDescriptions()) {
-                subtaskDescJson.push_back(desc);
-            }
-            templateJson["subtaskDescriptions"] = subtaskDescJson;
-
-            json tagsJson = json::array();
-            for (const auto& tag : templ.getTags()) {
-                tagsJson.push_back(tag);
-            }
-            templateJson["tags"] = tagsJson;
-
-            templatesJson.push_back(templateJson);
+            templatesJson.push_back(Schema::toJson(templ));
         }
 
         std::ofstream file(filename);
@@ -594,35 +672,10 @@ bool ExportService::importTemplates(const std::string& filename, std::map<std::s
 
         for (const auto& templateJson : jsonData) {
             try {
-                TaskTemplate templ;
-
-                templ.setName(templateJson["name"]);
-                templ.setDescription(templateJson["description"]);
-                templ.setCategory(templateJson["category"]);
-                templ.setPriority(templateJson["priority"]);
-                templ.setRecurrence(static_cast<Recurrence>(templateJson["recurrence"].get<int>()));
-
-                if (templateJson.contains("notes")) {
-                    templ.setNotes(templateJson["notes"]);
-                }
-
-                if (templateJson.contains("projectGroup")) {
-                    templ.setProjectGroup(templateJson["projectGroup"]);
-                }
-
-                if (templateJson.contains("subtaskDescriptions") && templateJson["subtaskDescriptions"].is_array()) {
-                    for (const auto& desc : templateJson["subtaskDescriptions"]) {
-                        templ.addSubtaskDescription(desc);
-                    }
-                }
-
-                if (templateJson.contains("tags") && templateJson["tags"].is_array()) {
-                    std::vector<std::string> tags;
-                    for (const auto& tag : templateJson["tags"]) {
-                        tags.push_back(tag);
-                    }
-                    templ.setTags(tags);
+                if (!templateJson.is_object() || !templateJson.contains("name")) {
+                    throw std::runtime_error("у шаблона нет названия");
                 }
+                TaskTemplate templ = Schema::fromJson<TaskTemplate>(templateJson);
 
                 templates[templ.getName()] = templ;
                 successCount++;
@@ -658,14 +711,53 @@ std::string ExportService::escapeCSV(const std::string& str) {
     return result;
 }
 
-std::string ExportService::getCurrentDate() {
-    auto now = std::chrono::system_clock::now();
-    auto now_time_t = std::chrono::system_clock::to_time_t(now);
-    std::tm* now_tm = std::localtime(&now_time_t);
+void ExportService::writeCSVRow(std::ostream& out, const std::vector<std::string>& cells) {
+    for (size_t i = 0; i < cells.size(); ++i) {
+        if (i > 0) {
+            out << ',';
+        }
+        out << '"' << escapeCSV(cells[i]) << '"';
+    }
+    out << '\n';
+}
 
-    char buffer[11];
-    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d", now_tm);
+bool ExportService::readCSVRow(std::istream& in, std::vector<std::string>& cells) {
+    cells.clear();
+    if (in.peek() == std::char_traits<char>::eof()) {
+        return false;
+    }
 
-    Logger::getInstance().debug("Текущая дата для экспорта: " + std::string(buffer));
-    return std::string(buffer);
+    std::string cell;
+    bool quoted = false;
+    char c;
+    while (in.get(c)) {
+        if (quoted) {
+            if (c == '"') {
+                if (in.peek() == '"') {
+                    cell.push_back(static_cast<char>(in.get()));
+                } else {
+                    quoted = false;
+                }
+            } else {
+                cell.push_back(c);
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            cells.push_back(std::move(cell));
+            cell.clear();
+        } else if (c == '\n') {
+            break;
+        } else if (c != '\r') {
+            cell.push_back(c);
+        }
+    }
+    cells.push_back(std::move(cell));
+    return true;
+}
+
+std::string ExportService::getCurrentDate() {
+    std::string today = Clock::todayString();
+    Logger::getInstance().debug("Текущая дата для экспорта: " + today);
+    return today;
 }
\ No newline at end of file
@@ -7,7 +7,27 @@
 #include <sstream>
 #include <iomanip>
 #include "../../include/services/logger.h"
-
+#include "../../include/services/json_sax_loader.h"
+#include "../../include/services/binary_snapshot.h"
+#include "../../include/services/schema_codec.h"
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using std::istringstream;
 using std::get_time;
@@ -15,6 +35,482 @@ namespace fs = std::filesystem;
 
 using nlohmann::json;
 
+namespace {
+
+void collectTaskIndexes(const std::vector<Task> &tasks, std::set<std::string> &projectGroups, int &nextId) {
+    std::unordered_set<Symbol> groups;
+    for (const auto &task: tasks) {
+        if (task.getId() >= nextId) {
+            nextId = task.getId() + 1;
+        }
+
+        if (!task.getProjectGroupSymbol().empty() && groups.insert(task.getProjectGroupSymbol()).second) {
+            projectGroups.insert(task.getProjectGroup());
+        }
+    }
+}
+
+class MappedFile {
+private:
+    const char *bytes;
+    size_t length;
+#ifdef _WIN32
+    std::vector<char> buffer;
+#endif
+
+public:
+    explicit MappedFile(const std::string &filename) : bytes(nullptr), length(0) {
+#ifdef _WIN32
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("не удалось открыть файл");
+        }
+        buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        bytes = buffer.data();
+        length = buffer.size();
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("не удалось открыть файл");
+        }
+
+        struct stat info {};
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("не удалось получить размер файла");
+        }
+
+        length = static_cast<size_t>(info.st_size);
+        if (length > 0) {
+            void *mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("не удалось отобразить файл в память");
+            }
+            bytes = static_cast<const char *>(mapped);
+        }
+        ::close(fd);
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (bytes) {
+            ::munmap(const_cast<char *>(bytes), length);
+        }
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
+// Файлы меньше этого размера быстрее разобрать одним потоком.
+constexpr uintmax_t PARALLEL_JSON_THRESHOLD = 16 * 1024 * 1024;
+// Частей больше, чем потоков, чтобы потоки не простаивали на неравных частях.
+constexpr size_t JSON_CHUNKS_PER_THREAD = 4;
+
+struct TaskArrayLayout {
+    size_t begin = 0;
+    size_t end = 0;
+    std::vector<std::pair<size_t, size_t>> elements;
+};
+
+bool isJsonSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// Находит массив "tasks" корневого объекта и границы его элементов, не разбирая
+// их содержимое. Возвращает false, если разметить файл не удалось: тогда он
+// разбирается потоковым загрузчиком, который и сообщит об ошибке.
+bool scanTaskArray(std::string_view text, TaskArrayLayout &layout) {
+    constexpr size_t none = std::string_view::npos;
+
+    int depth = 0;
+    bool inTasks = false;
+    bool found = false;
+    std::string_view lastString;
+    std::string_view key;
+    size_t elementBegin = none;
+
+    auto finishElement = [&](size_t end) {
+        if (elementBegin == none) {
+            return false;
+        }
+        while (end > elementBegin && isJsonSpace(text[end - 1])) {
+            end--;
+        }
+        layout.elements.emplace_back(elementBegin, end);
+        elementBegin = none;
+        return true;
+    };
+
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (isJsonSpace(c)) {
+            continue;
+        }
+        if (inTasks && depth == 2 && elementBegin == none && c != ',' && c != ']') {
+            elementBegin = i;
+        }
+
+        switch (c) {
+            case '"': {
+                size_t start = i + 1;
+                const char *cursor = text.data() + start;
+                const char *finish = text.data() + text.size();
+                while (true) {
+                    auto quote = static_cast<const char *>(std::memchr(cursor, '"', finish - cursor));
+                    if (!quote) {
+                        return false;
+                    }
+                    size_t slashes = 0;
+                    while (quote - slashes > cursor && quote[-1 - static_cast<ptrdiff_t>(slashes)] == '\\') {
+                        slashes++;
+                    }
+                    if (slashes % 2 == 0) {
+                        i = static_cast<size_t>(quote - text.data());
+                        break;
+                    }
+                    cursor = quote + 1;
+                }
+                if (depth == 1) {
+                    lastString = text.substr(start, i - start);
+                }
+                break;
+            }
+            case ':':
+                if (depth == 1) {
+                    key = lastString;
+                }
+                break;
+            case '{':
+            case '[':
+                if (depth == 1 && c == '[' && key == "tasks") {
+                    if (found) {
+                        return false;
+                    }
+                    inTasks = true;
+                    layout.begin = i;
+                }
+                depth++;
+                break;
+            case '}':
+            case ']':
+                if (--depth < 0) {
+                    return false;
+                }
+                if (inTasks && depth == 1) {
+                    if (!layout.elements.empty() || elementBegin != none) {
+                        if (!finishElement(i)) {
+                            return false;
+                        }
+                    }
+                    inTasks = false;
+                    found = true;
+                    layout.end = i + 1;
+                }
+                break;
+            case ',':
+                if (inTasks && depth == 2 && !finishElement(i)) {
+                    return false;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return found && depth == 0;
+}
+
+struct TaskChunk {
+    std::vector<Task> tasks;
+    std::set<std::string> projectGroups;
+    int nextId = 1;
+    std::string error;
+};
+
+// Разбирает элементы массива "tasks" частями в нескольких потоках. Части
+// склеиваются в исходном порядке файла, nextId и группы проектов собираются
+// в каждой части отдельно и затем объединяются.
+bool parseTasksInParallel(std::string_view text, const TaskArrayLayout &layout, size_t threadCount,
+                          std::vector<Task> &tasks, std::set<std::string> &projectGroups, int &nextId,
+                          std::string &error) {
+    const auto &elements = layout.elements;
+    size_t chunkCount = std::min(elements.size(), threadCount * JSON_CHUNKS_PER_THREAD);
+    std::vector<TaskChunk> chunks(chunkCount);
+    std::atomic<size_t> nextChunk{0};
+
+    auto work = [&]() {
+        for (size_t index = nextChunk++; index < chunkCount; index = nextChunk++) {
+            TaskChunk &chunk = chunks[index];
+            size_t first = elements.size() * index / chunkCount;
+            size_t last = elements.size() * (index + 1) / chunkCount;
+            chunk.tasks.reserve(last - first);
+            try {
+                JsonSaxLoader loader(chunk.tasks);
+                for (size_t i = first; i < last; ++i) {
+                    const char *begin = text.data() + elements[i].first;
+                    const char *end = text.data() + elements[i].second;
+                    if (!json::sax_parse(begin, end, &loader)) {
+                        chunk.error = "задача #" + std::to_string(i) + ", " + loader.getErrorMessage();
+                        break;
+                    }
+                }
+                collectTaskIndexes(chunk.tasks, chunk.projectGroups, chunk.nextId);
+            } catch (const std::exception &e) {
+                chunk.error = e.what();
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < std::min(threadCount, chunkCount); ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto &worker: workers) {
+        worker.join();
+    }
+
+    size_t total = 0;
+    for (const auto &chunk: chunks) {
+        if (!chunk.error.empty()) {
+            error = chunk.error;
+            return false;
+        }
+        total += chunk.tasks.size();
+    }
+
+    tasks.reserve(tasks.size() + total);
+    for (auto &chunk: chunks) {
+        std::move(chunk.tasks.begin(), chunk.tasks.end(), std::back_inserter(tasks));
+        projectGroups.merge(chunk.projectGroups);
+        nextId = std::max(nextId, chunk.nextId);
+    }
+    return true;
+}
+
+// Секция снимка: блоки фиксированной ширины всех записей, затем общий хвост.
+struct BinarySection {
+    std::string fixed;
+    std::string tail;
+    uint32_t count = 0;
+
+    template<typename T>
+    void add(const T &object, Schema::StringTable &strings) {
+        Schema::BinaryWriter fixedWriter(fixed, strings);
+        Schema::BinaryWriter tailWriter(tail, strings);
+        Schema::writeRecord(fixedWriter, tailWriter, object);
+        count++;
+    }
+
+    size_t size() const { return fixed.size() + tail.size(); }
+};
+
+class BinarySnapshotBuilder {
+private:
+    Schema::StringTable strings;
+    BinarySection taskData;
+    BinarySection reminderData;
+    BinarySection templateData;
+
+public:
+    void addTask(const Task &task) { taskData.add(task, strings); }
+    void addReminder(const Reminder &reminder) { reminderData.add(reminder, strings); }
+    void addTemplate(const TaskTemplate &templ) { templateData.add(templ, strings); }
+
+    std::string build(int64_t journalSequence) const {
+        const std::vector<uint32_t> &offsets = strings.getOffsets();
+
+        BinarySnapshot::Header header{};
+        std::memcpy(header.magic, BinarySnapshot::MAGIC, sizeof(header.magic));
+        header.version = BinarySnapshot::VERSION;
+        header.byteOrderMark = BinarySnapshot::BYTE_ORDER_MARK;
+        header.journalSequence = journalSequence;
+        header.taskCount = taskData.count;
+        header.reminderCount = reminderData.count;
+        header.templateCount = templateData.count;
+        header.stringCount = strings.size();
+        header.taskOffset = sizeof(header);
+        header.reminderOffset = header.taskOffset + taskData.size();
+        header.templateOffset = header.reminderOffset + reminderData.size();
+        header.stringIndexOffset = header.templateOffset + templateData.size();
+        header.stringTableOffset = header.stringIndexOffset + offsets.size() * sizeof(uint32_t);
+        header.stringTableSize = strings.getBytes().size();
+
+        std::string out;
+        out.reserve(header.stringTableOffset + header.stringTableSize);
+        out.append(reinterpret_cast<const char *>(&header), sizeof(header));
+        for (const BinarySection *section: {&taskData, &reminderData, &templateData}) {
+            out.append(section->fixed);
+            out.append(section->tail);
+        }
+        out.append(reinterpret_cast<const char *>(offsets.data()), offsets.size() * sizeof(uint32_t));
+        out.append(strings.getBytes());
+        return out;
+    }
+};
+
+class BinarySnapshotReader {
+private:
+    const char *base;
+    size_t size;
+    BinarySnapshot::Header header{};
+
+public:
+    BinarySnapshotReader(const char *data, size_t length) : base(data), size(length) {
+        if (size < sizeof(header)) {
+            throw std::runtime_error("файл слишком мал для снимка");
+        }
+        std::memcpy(&header, base, sizeof(header));
+
+        if (std::memcmp(header.magic, BinarySnapshot::MAGIC, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("неизвестная сигнатура снимка");
+        }
+        if (header.byteOrderMark != BinarySnapshot::BYTE_ORDER_MARK) {
+            throw std::runtime_error("снимок записан на платформе с другим порядком байт");
+        }
+        if (header.version != BinarySnapshot::VERSION) {
+            throw std::runtime_error("неподдерживаемая версия снимка: " + std::to_string(header.version));
+        }
+
+        const bool ordered = header.taskOffset == sizeof(header) &&
+                             header.taskOffset <= header.reminderOffset &&
+                             header.reminderOffset <= header.templateOffset &&
+                             header.templateOffset <= header.stringIndexOffset &&
+                             header.stringIndexOffset + (uint64_t{header.stringCount} + 1) * sizeof(uint32_t) ==
+                             header.stringTableOffset &&
+                             header.stringTableOffset <= size &&
+                             header.stringTableSize == size - header.stringTableOffset;
+        if (!ordered) {
+            throw std::runtime_error("поврежденный снимок: секции выходят за границы файла");
+        }
+    }
+
+    const BinarySnapshot::Header &getHeader() const { return header; }
+
+    template<typename T, typename Consumer>
+    void readSection(uint64_t begin, uint64_t end, uint32_t count, Consumer &&consume) const {
+        constexpr size_t recordSize = Schema::fixedRecordSize<T>();
+        const uint64_t tailBegin = begin + uint64_t{count} * recordSize;
+        if (tailBegin > end) {
+            throw std::runtime_error("поврежденный снимок: записи выходят за границы секции");
+        }
+
+        Schema::BinaryReader reader(base + tailBegin, base + end,
+                                    base + header.stringTableOffset, header.stringTableSize,
+                                    base + header.stringIndexOffset, header.stringCount);
+        const char *fixed = base + begin;
+        for (uint32_t i = 0; i < count; ++i, fixed += recordSize) {
+            T object;
+            Schema::readRecord(fixed, reader, object);
+            consume(std::move(object));
+        }
+        if (!reader.atEnd()) {
+            throw std::runtime_error("поврежденный снимок: лишние данные в секции");
+        }
+    }
+};
+
+void readBinarySnapshot(const std::string &filename,
+                        std::vector<Task> &tasks,
+                        std::vector<Reminder> &reminders,
+                        std::map<std::string, TaskTemplate> &templates,
+                        int64_t &journalSequence) {
+    MappedFile mapped(filename);
+    BinarySnapshotReader reader(mapped.data(), mapped.size());
+    const BinarySnapshot::Header &header = reader.getHeader();
+
+    reader.readSection<Task>(header.taskOffset, header.reminderOffset, header.taskCount,
+                             [&](Task &&task) { tasks.push_back(std::move(task)); });
+
+    reader.readSection<Reminder>(header.reminderOffset, header.templateOffset, header.reminderCount,
+                                 [&](Reminder &&reminder) { reminders.push_back(std::move(reminder)); });
+
+    reader.readSection<TaskTemplate>(header.templateOffset, header.stringIndexOffset, header.templateCount,
+                                     [&](TaskTemplate &&templ) {
+                                         std::string name = templ.getName();
+                                         templates[name] = std::move(templ);
+                                     });
+
+    journalSequence = header.journalSequence;
+}
+
+std::string serializeManifest(const FileService::SegmentManifest &manifest) {
+    BinarySnapshot::ManifestHeader header{};
+    std::memcpy(header.magic, BinarySnapshot::MANIFEST_MAGIC, sizeof(header.magic));
+    header.version = BinarySnapshot::MANIFEST_VERSION;
+    header.byteOrderMark = BinarySnapshot::BYTE_ORDER_MARK;
+    header.journalSequence = manifest.journalSequence;
+    header.segmentSize = manifest.segmentSize;
+    header.segmentCount = static_cast<uint32_t>(manifest.segments.size());
+    header.orderCount = static_cast<uint32_t>(manifest.order.size());
+
+    std::vector<BinarySnapshot::ManifestSegment> segments;
+    segments.reserve(manifest.segments.size());
+    for (const auto &[key, fileSequence]: manifest.segments) {
+        segments.push_back({key, 0, fileSequence});
+    }
+
+    std::string out;
+    out.reserve(sizeof(header) + segments.size() * sizeof(BinarySnapshot::ManifestSegment) +
+                manifest.order.size() * sizeof(int32_t));
+    out.append(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.append(reinterpret_cast<const char *>(segments.data()),
+               segments.size() * sizeof(BinarySnapshot::ManifestSegment));
+    out.append(reinterpret_cast<const char *>(manifest.order.data()), manifest.order.size() * sizeof(int32_t));
+    return out;
+}
+
+FileService::SegmentManifest readManifest(const std::string &filename) {
+    MappedFile mapped(filename);
+
+    BinarySnapshot::ManifestHeader header{};
+    if (mapped.size() < sizeof(header)) {
+        throw std::runtime_error("файл слишком мал для манифеста");
+    }
+    std::memcpy(&header, mapped.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, BinarySnapshot::MANIFEST_MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("неверная сигнатура манифеста");
+    }
+    if (header.version != BinarySnapshot::MANIFEST_VERSION) {
+        throw std::runtime_error("неподдерживаемая версия манифеста " + std::to_string(header.version));
+    }
+    if (header.byteOrderMark != BinarySnapshot::BYTE_ORDER_MARK) {
+        throw std::runtime_error("манифест записан на платформе с другим порядком байт");
+    }
+
+    const uint64_t expected = sizeof(header) +
+                              uint64_t{header.segmentCount} * sizeof(BinarySnapshot::ManifestSegment) +
+                              uint64_t{header.orderCount} * sizeof(int32_t);
+    if (expected != mapped.size()) {
+        throw std::runtime_error("поврежденный манифест: неверный размер файла");
+    }
+
+    FileService::SegmentManifest manifest;
+    manifest.journalSequence = header.journalSequence;
+    manifest.segmentSize = header.segmentSize;
+
+    const char *cursor = mapped.data() + sizeof(header);
+    for (uint32_t i = 0; i < header.segmentCount; ++i) {
+        BinarySnapshot::ManifestSegment segment{};
+        std::memcpy(&segment, cursor, sizeof(segment));
+        cursor += sizeof(segment);
+        manifest.segments[segment.key] = segment.fileSequence;
+    }
+
+    manifest.order.resize(header.orderCount);
+    std::memcpy(manifest.order.data(), cursor, manifest.order.size() * sizeof(int32_t));
+    return manifest;
+}
+
+}
+
 
 bool FileService::loadFromJson(const std::string &filename,
                                std::vector<Task> &tasks,
@@ -22,9 +518,20 @@ bool FileService::loadFromJson(const std::string &filename,
                                std::map<std::string, TaskTemplate> &templates,
                                std::set<std::string> &projectGroups,
                                int &nextId) {
+    int64_t journalSequence = 0;
+    return loadFromJson(filename, tasks, reminders, templates, projectGroups, nextId, journalSequence);
+}
+
+bool FileService::loadFromJson(const std::string &filename,
+                               std::vector<Task> &tasks,
+                               std::vector<Reminder> &reminders,
+                               std::map<std::string, TaskTemplate> &templates,
+                               std::set<std::string> &projectGroups,
+                               int &nextId,
+                               int64_t &journalSequence) {
     Logger::getInstance().info("Загрузка данных из файла: " + filename);
 
-    std::ifstream file(filename);
+    std::ifstream file(filename, std::ios::binary);
     if (!file.is_open()) {
         Logger::getInstance().error("Не удалось открыть файл: " + filename);
         std::cerr << "Не удалось открыть файл: " << filename << std::endl;
@@ -32,52 +539,65 @@ bool FileService::loadFromJson(const std::string &filename,
     }
 
     try {
-        json jsonData;
-        file >> jsonData;
-
         tasks.clear();
         reminders.clear();
         templates.clear();
         projectGroups.clear();
         nextId = 1;
 
-        if (jsonData.contains("tasks") && jsonData["tasks"].is_array()) {
-            for (const auto &taskJson: jsonData["tasks"]) {
-                Task task = jsonToTask(taskJson);
-                tasks.push_back(task);
-
-                if (task.getId() >= nextId) {
-                    nextId = task.getId() + 1;
+        size_t threadCount = std::thread::hardware_concurrency();
+        std::error_code sizeError;
+        uintmax_t fileSize = fs::file_size(filename, sizeError);
+        bool parallel = false;
+
+        if (threadCount > 1 && !sizeError && fileSize >= PARALLEL_JSON_THRESHOLD) {
+            file.close();
+            MappedFile mapped(filename);
+            std::string_view text(mapped.data(), mapped.size());
+
+            TaskArrayLayout layout;
+            if (scanTaskArray(text, layout)) {
+                // Все, кроме задач, разбирается обычным загрузчиком по копии без массива "tasks".
+                std::string rest;
+                rest.reserve(text.size() - (layout.end - layout.begin) + 2);
+                rest.append(text.substr(0, layout.begin));
+                rest.append("[]");
+                rest.append(text.substr(layout.end));
+
+                JsonSaxLoader loader(tasks, reminders, templates);
+                std::string error;
+                if (!json::sax_parse(rest, &loader)) {
+                    error = loader.getErrorMessage();
+                } else {
+                    parseTasksInParallel(text, layout, threadCount, tasks, projectGroups, nextId, error);
                 }
-
-                if (!task.getProjectGroup().empty()) {
-                    projectGroups.insert(task.getProjectGroup());
-                }
-
-                for (const auto &subtask: task.getSubtasks()) {
-                    if (subtask.getId() >= nextId) {
-                        nextId = subtask.getId() + 1;
-                    }
+                if (!error.empty()) {
+                    Logger::getInstance().error("Ошибка при загрузке из JSON: " + error);
+                    std::cerr << "Ошибка при загрузке из JSON: " << error << std::endl;
+                    return false;
                 }
+                journalSequence = loader.getJournalSequence();
+                parallel = true;
+            } else {
+                file.open(filename, std::ios::binary);
             }
-            Logger::getInstance().info("Загружено " + std::to_string(tasks.size()) + " задач");
         }
 
-        if (jsonData.contains("reminders") && jsonData["reminders"].is_array()) {
-            for (const auto &reminderJson: jsonData["reminders"]) {
-                reminders.push_back(jsonToReminder(reminderJson));
+        if (!parallel) {
+            JsonSaxLoader loader(tasks, reminders, templates);
+            if (!json::sax_parse(file, &loader)) {
+                Logger::getInstance().error("Ошибка при загрузке из JSON: " + loader.getErrorMessage());
+                std::cerr << "Ошибка при загрузке из JSON: " << loader.getErrorMessage() << std::endl;
+                return false;
             }
-            Logger::getInstance().info("Загружено " + std::to_string(reminders.size()) + " напоминаний");
-        }
+            journalSequence = loader.getJournalSequence();
 
-        if (jsonData.contains("templates") && jsonData["templates"].is_array()) {
-            for (const auto &templateJson: jsonData["templates"]) {
-                TaskTemplate templ = jsonToTemplate(templateJson);
-                templates[templ.getName()] = templ;
-            }
-            Logger::getInstance().info("Загружено " + std::to_string(templates.size()) + " шаблонов");
+            collectTaskIndexes(tasks, projectGroups, nextId);
         }
 
+        Logger::getInstance().info("Загружено " + std::to_string(tasks.size()) + " задач");
+        Logger::getInstance().info("Загружено " + std::to_string(reminders.size()) + " напоминаний");
+        Logger::getInstance().info("Загружено " + std::to_string(templates.size()) + " шаблонов");
         Logger::getInstance().info("Данные успешно загружены из файла: " + filename);
         return true;
     } catch (const std::exception &e) {
@@ -87,53 +607,278 @@ bool FileService::loadFromJson(const std::string &filename,
     }
 }
 
+std::string FileService::serializeToJson(const std::vector<Task> &tasks,
+                                         const std::vector<Reminder> &reminders,
+                                         const std::map<std::string, TaskTemplate> &templates,
+                                         int64_t journalSequence) {
+    std::string out;
+    Schema::JsonWriter writer(out);
+
+    writer.beginObject();
+    writer.key("journalSequence");
+    writer.integer(journalSequence);
+
+    writer.key("reminders");
+    writer.beginArray();
+    for (const auto &reminder: reminders) {
+        Schema::writeJson(writer, reminder);
+    }
+    writer.endArray();
+
+    writer.key("tasks");
+    writer.beginArray();
+    for (const auto &task: tasks) {
+        Schema::writeJson(writer, task);
+    }
+    writer.endArray();
+
+    writer.key("templates");
+    writer.beginArray();
+    for (const auto &[name, templ]: templates) {
+        Schema::writeJson(writer, templ);
+    }
+    writer.endArray();
+    writer.endObject();
+
+    return out;
+}
+
 bool FileService::saveToJson(const std::string &filename,
                              const std::vector<Task> &tasks,
                              const std::vector<Reminder> &reminders,
                              const std::map<std::string, TaskTemplate> &templates,
-                             const std::set<std::string> &projectGroups) {
+                             const std::set<std::string> &projectGroups,
+                             int64_t journalSequence) {
     Logger::getInstance().info("Сохранение данных в файл: " + filename);
 
-    json jsonData;
+    try {
+        if (!writeFileAtomically(filename, serializeToJson(tasks, reminders, templates, journalSequence))) {
+            std::cerr << "Не удалось сохранить файл: " << filename << std::endl;
+            return false;
+        }
 
-    json tasksJson = json::array();
-    for (const auto &task: tasks) {
-        tasksJson.push_back(taskToJson(task));
+        Logger::getInstance().info("Данные успешно сохранены в файл: " + filename);
+        return true;
+    } catch (const std::exception &e) {
+        Logger::getInstance().error("Ошибка при сохранении в JSON: " + std::string(e.what()));
+        std::cerr << "Ошибка при сохранении в JSON: " << e.what() << std::endl;
+        return false;
     }
-    jsonData["tasks"] = tasksJson;
+}
 
-    json remindersJson = json::array();
+std::string FileService::serializeToBinary(const std::vector<Task> &tasks,
+                                           const std::vector<Reminder> &reminders,
+                                           const std::map<std::string, TaskTemplate> &templates,
+                                           int64_t journalSequence) {
+    BinarySnapshotBuilder builder;
+    for (const auto &task: tasks) {
+        builder.addTask(task);
+    }
     for (const auto &reminder: reminders) {
-        remindersJson.push_back(reminderToJson(reminder));
+        builder.addReminder(reminder);
     }
-    jsonData["reminders"] = remindersJson;
-
-    json templatesJson = json::array();
     for (const auto &[name, templ]: templates) {
-        templatesJson.push_back(templateToJson(templ));
+        builder.addTemplate(templ);
+    }
+    return builder.build(journalSequence);
+}
+
+std::string FileService::segmentFileName(int32_t key, int64_t fileSequence) {
+    const std::string suffix = "-" + std::to_string(fileSequence) + ".bin";
+    switch (key) {
+        case SegmentManifest::REMINDERS_SEGMENT:
+            return "reminders" + suffix;
+        case SegmentManifest::TEMPLATES_SEGMENT:
+            return "templates" + suffix;
+        default:
+            return "tasks-" + std::to_string(key) + suffix;
     }
-    jsonData["templates"] = templatesJson;
+}
 
+bool FileService::saveSegments(const std::string &directory,
+                               const SegmentManifest &manifest,
+                               const std::map<int32_t, SegmentData> &changedSegments) {
     try {
-        std::ofstream file(filename);
-        if (!file.is_open()) {
-            Logger::getInstance().error("Не удалось открыть файл для записи: " + filename);
-            std::cerr << "Не удалось открыть файл для записи: " << filename << std::endl;
+        fs::create_directories(directory);
+
+        size_t written = 0;
+        for (const auto &[key, segment]: changedSegments) {
+            auto entry = manifest.segments.find(key);
+            if (entry == manifest.segments.end()) {
+                continue;
+            }
+
+            const std::string path = (fs::path(directory) / segmentFileName(key, entry->second)).string();
+            if (!writeFileAtomically(path, serializeToBinary(segment.tasks, segment.reminders, segment.templates,
+                                                             manifest.journalSequence))) {
+                return false;
+            }
+            written++;
+        }
+
+        if (!writeFileAtomically((fs::path(directory) / "manifest.bin").string(), serializeManifest(manifest))) {
             return false;
         }
 
-        file << jsonData.dump(4);
-        file.close();
+        std::set<std::string> referenced = {"manifest.bin"};
+        for (const auto &[key, fileSequence]: manifest.segments) {
+            referenced.insert(segmentFileName(key, fileSequence));
+        }
 
-        Logger::getInstance().info("Данные успешно сохранены в файл: " + filename);
+        std::error_code error;
+        for (const auto &entry: fs::directory_iterator(directory, error)) {
+            if (referenced.count(entry.path().filename().string()) == 0) {
+                fs::remove(entry.path(), error);
+            }
+        }
+
+        Logger::getInstance().info("Записано сегментов: " + std::to_string(written) + " из " +
+                                   std::to_string(manifest.segments.size()));
         return true;
     } catch (const std::exception &e) {
-        Logger::getInstance().error("Ошибка при сохранении в JSON: " + std::string(e.what()));
-        std::cerr << "Ошибка при сохранении в JSON: " << e.what() << std::endl;
+        Logger::getInstance().error("Ошибка при сохранении сегментов в " + directory + ": " + e.what());
         return false;
     }
 }
 
+bool FileService::loadSegments(const std::string &directory,
+                               uint32_t segmentSize,
+                               std::vector<Task> &tasks,
+                               std::vector<Reminder> &reminders,
+                               std::map<std::string, TaskTemplate> &templates,
+                               std::set<std::string> &projectGroups,
+                               int &nextId,
+                               SegmentManifest &manifest) {
+    Logger::getInstance().info("Загрузка сегментов из каталога: " + directory);
+
+    try {
+        SegmentManifest loadedManifest = readManifest((fs::path(directory) / "manifest.bin").string());
+        if (loadedManifest.segmentSize != segmentSize) {
+            throw std::runtime_error("сегменты записаны по " + std::to_string(loadedManifest.segmentSize) +
+                                     " задач, ожидалось " + std::to_string(segmentSize));
+        }
+
+        // Сегменты дописываются в один вектор: резерв под весь порядок из манифеста,
+        // а не по сегменту, иначе каждый сегмент заново копирует все прочитанное.
+        std::vector<Task> loadedTasks;
+        loadedTasks.reserve(loadedManifest.order.size());
+        std::vector<Reminder> loadedReminders;
+        std::map<std::string, TaskTemplate> loadedTemplates;
+        for (const auto &[key, fileSequence]: loadedManifest.segments) {
+            int64_t segmentSequence = 0;
+            readBinarySnapshot((fs::path(directory) / segmentFileName(key, fileSequence)).string(),
+                               loadedTasks, loadedReminders, loadedTemplates, segmentSequence);
+        }
+
+        std::unordered_map<int, size_t> positions;
+        positions.reserve(loadedTasks.size());
+        for (size_t i = 0; i < loadedTasks.size(); ++i) {
+            positions[loadedTasks[i].getId()] = i;
+        }
+
+        std::vector<Task> orderedTasks;
+        orderedTasks.reserve(loadedTasks.size());
+        std::vector<bool> placed(loadedTasks.size(), false);
+        for (int32_t id: loadedManifest.order) {
+            auto it = positions.find(id);
+            if (it != positions.end() && !placed[it->second]) {
+                placed[it->second] = true;
+                orderedTasks.push_back(std::move(loadedTasks[it->second]));
+            }
+        }
+        // Порядок из манифеста — полный список живых задач; запись, которой в нем нет,
+        // осталась в непереписанном сегменте после удаления и не должна ожить.
+        size_t staleCount = loadedTasks.size() - orderedTasks.size();
+        if (staleCount > 0) {
+            Logger::getInstance().warning("Пропущено " + std::to_string(staleCount) +
+                                          " устаревших задач, отсутствующих в манифесте");
+        }
+
+        tasks = std::move(orderedTasks);
+        reminders = std::move(loadedReminders);
+        templates = std::move(loadedTemplates);
+        manifest = std::move(loadedManifest);
+        projectGroups.clear();
+        nextId = 1;
+        collectTaskIndexes(tasks, projectGroups, nextId);
+
+        Logger::getInstance().info("Из " + std::to_string(manifest.segments.size()) + " сегментов загружено " +
+                                   std::to_string(tasks.size()) + " задач");
+        return true;
+    } catch (const std::exception &e) {
+        Logger::getInstance().error("Ошибка при загрузке сегментов из " + directory + ": " + e.what());
+        return false;
+    }
+}
+
+bool FileService::writeFileAtomically(const std::string &filename, const std::string &data) {
+    const std::string tempFile = filename + ".tmp";
+
+#ifdef _WIN32
+    {
+        std::ofstream file(tempFile, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            Logger::getInstance().error("Не удалось открыть временный файл для записи: " + tempFile);
+            return false;
+        }
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        file.flush();
+        if (!file) {
+            Logger::getInstance().error("Ошибка записи во временный файл: " + tempFile);
+            return false;
+        }
+    }
+#else
+    int fd = ::open(tempFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        Logger::getInstance().error("Не удалось открыть временный файл для записи: " + tempFile);
+        return false;
+    }
+
+    const char *cursor = data.data();
+    size_t remaining = data.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, cursor, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Logger::getInstance().error("Ошибка записи во временный файл: " + tempFile);
+            ::close(fd);
+            ::unlink(tempFile.c_str());
+            return false;
+        }
+        cursor += written;
+        remaining -= static_cast<size_t>(written);
+    }
+
+    if (::fsync(fd) != 0 || ::close(fd) != 0) {
+        Logger::getInstance().error("Не удалось сбросить временный файл на диск: " + tempFile);
+        ::unlink(tempFile.c_str());
+        return false;
+    }
+#endif
+
+    std::error_code error;
+    fs::rename(tempFile, filename, error);
+    if (error) {
+        Logger::getInstance().error("Не удалось заменить файл " + filename + ": " + error.message());
+        fs::remove(tempFile, error);
+        return false;
+    }
+
+#ifndef _WIN32
+    fs::path directory = fs::path(filename).parent_path();
+    int dirFd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+#endif
+
+    return true;
+}
+
 bool FileService::createBackup(const std::string &originalFile, const std::string &backupFile) {
     try {
         if (!fileExists(originalFile)) {
@@ -169,164 +914,41 @@ bool FileService::fileExists(const std::string &filename) {
 }
 
 json FileService::taskToJson(const Task &task) {
-    json taskJson;
-    taskJson["id"] = task.getId();
-    taskJson["description"] = task.getDescription();
-    taskJson["dueDate"] = task.getDueDate();
-    taskJson["priority"] = task.getPriority();
-    taskJson["category"] = task.getCategory();
-    taskJson["completed"] = task.isCompleted();
-    taskJson["recurrence"] = static_cast<int>(task.getRecurrence());
-    taskJson["notes"] = task.getNotes();
-    taskJson["createdDate"] = task.getCreatedDate();
-    taskJson["projectGroup"] = task.getProjectGroup();
-
-    json tagsJson = json::array();
-    for (const auto &tag: task.getTags()) {
-        tagsJson.push_back(tag);
-    }
-    taskJson["tags"] = tagsJson;
-
-    if (!task.getSubtasks().empty()) {
-        json subtasksJson = json::array();
-        for (const auto &subtask: task.getSubtasks()) {
-            json subtaskJson = taskToJson(subtask);
-            subtaskJson.erase("subtasks");
-            subtasksJson.push_back(subtaskJson);
-        }
-        taskJson["subtasks"] = subtasksJson;
-    }
-
-    return taskJson;
+    return Schema::toJson(task);
 }
 
 Task FileService::jsonToTask(const json &j) {
-    Task task;
-
-    task.setId(j["id"]);
-    task.setDescription(j["description"]);
-    task.setDueDate(j["dueDate"]);
-    task.setPriority(j["priority"]);
-    task.setCategory(j["category"]);
-    task.setCompleted(j["completed"]);
-    task.setRecurrence(static_cast<Recurrence>(j["recurrence"].get<int>()));
-
-    if (j.contains("notes")) {
-        task.setNotes(j["notes"]);
-    }
-
-    if (j.contains("createdDate")) {
-        task.setCreatedDate(j["createdDate"]);
-    }
-
-    if (j.contains("projectGroup")) {
-        task.setProjectGroup(j["projectGroup"]);
-    }
-
-    if (j.contains("tags") && j["tags"].is_array()) {
-        std::vector<std::string> tags;
-        for (const auto &tagJson: j["tags"]) {
-            tags.push_back(tagJson);
-        }
-        task.setTags(tags);
-    }
+    return Schema::fromJson<Task>(j);
+}
 
-    if (j.contains("subtasks") && j["subtasks"].is_array()) {
-        for (const auto &subtaskJson: j["subtasks"]) {
-            Task subtask = jsonToTask(subtaskJson);
-            task.addSubtask(subtask);
+std::vector<Task> FileService::jsonToTaskTree(const json &j) {
+    std::vector<Task> tasks;
+    tasks.push_back(jsonToTask(j));
+
+    auto subtasks = j.find("subtasks");
+    if (subtasks != j.end() && subtasks->is_array()) {
+        int parentId = tasks.front().getId();
+        for (const auto &subtaskJson: *subtasks) {
+            std::vector<Task> subtree = jsonToTaskTree(subtaskJson);
+            subtree.front().setParentId(parentId);
+            tasks.insert(tasks.end(), std::make_move_iterator(subtree.begin()), std::make_move_iterator(subtree.end()));
         }
     }
-
-    return task;
+    return tasks;
 }
 
 json FileService::reminderToJson(const Reminder &reminder) {
-    json reminderJson;
-    reminderJson["taskId"] = reminder.getTaskId();
-    reminderJson["message"] = reminder.getMessage();
-    reminderJson["shown"] = reminder.isShown();
-
-    auto timeT = std::chrono::system_clock::to_time_t(reminder.getTime());
-    std::tm *tm = std::localtime(&timeT);
-    char buffer[20];
-    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M", tm);
-    reminderJson["time"] = std::string(buffer);
-
-    return reminderJson;
+    return Schema::toJson(reminder);
 }
 
 Reminder FileService::jsonToReminder(const json &j) {
-    Reminder reminder;
-
-    reminder.setTaskId(j["taskId"]);
-    reminder.setMessage(j["message"]);
-    reminder.setShown(j["shown"]);
-
-    std::string timeStr = j["time"];
-    std::tm tm = {};
-    std::istringstream ss(timeStr);
-    ss >> std::get_time(&tm, "%Y-%m-%d %H:%M");
-    reminder.setTime(std::chrono::system_clock::from_time_t(std::mktime(&tm)));
-
-    return reminder;
+    return Schema::fromJson<Reminder>(j);
 }
 
 json FileService::templateToJson(const TaskTemplate &templ) {
-    json templateJson;
-    templateJson["name"] = templ.getName();
-    templateJson["description"] = templ.getDescription();
-    templateJson["category"] = templ.getCategory();
-    templateJson["priority"] = templ.getPriority();
-    templateJson["recurrence"] = static_cast<int>(templ.getRecurrence());
-    templateJson["notes"] = templ.getNotes();
-    templateJson["projectGroup"] = templ.getProjectGroup();
-
-    json subtaskDescJson = json::array();
-    for (const auto &desc: templ.getSubtaskDescriptions()) {
-        subtaskDescJson.push_back(desc);
-    }
-    templateJson["subtaskDescriptions"] = subtaskDescJson;
-
-    json tagsJson = json::array();
-    for (const auto &tag: templ.getTags()) {
-        tagsJson.push_back(tag);
-    }
-    templateJson["tags"] = tagsJson;
-
-    return templateJson;
+    return Schema::toJson(templ);
 }
 
 TaskTemplate FileService::jsonToTemplate(const json &j) {
-    TaskTemplate templ;
-
-    templ.setName(j["name"]);
-    templ.setDescription(j["description"]);
-    templ.setCategory(j["category"]);
-    templ.setPriority(j["priority"]);
-    templ.setRecurrence(static_cast<Recurrence>(j["recurrence"].get<int>()));
-
-    if (j.contains("notes")) {
-        templ.setNotes(j["notes"]);
-    }
-
-    if (j.contains("projectGroup")) {
-        templ.setProjectGroup(j["projectGroup"]);
-    }
-
-    if (j.contains("subtaskDescriptions") && j["subtaskDescriptions"].is_array()) {
-        for (const auto &descJson: j["subtaskDescriptions"]) {
-            templ.addSubtaskDescription(descJson);
-        }
-    }
-
-    if (j.contains("tags") && j["tags"].is_array()) {
-        std::vector<std::string> tags;
-        for (const auto &tagJson: j["tags"]) {
-            tags.push_back(tagJson);
-        }
-        templ.setTags(tags);
-    }
-
-    return templ;
+    return Schema::fromJson<TaskTemplate>(j);
 }
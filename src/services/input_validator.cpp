@@ -5,35 +5,13 @@
 #include <ctime>
 
 bool InputValidator::isValidDate(const std::string& date) {
-    std::regex dateRegex(R"(^\d{4}-\d{2}-\d{2}$)");
-    if (!std::regex_match(date, dateRegex)) {
+    auto parsed = Date::parse(date);
+    if (!parsed) {
         return false;
     }
-    
-    try {
-        int year = std::stoi(date.substr(0, 4));
-        int month = std::stoi(date.substr(5, 2));
-        int day = std::stoi(date.substr(8, 2));
-
-        if (year < 1900 || year > 2100 || month < 1 || month > 12 || day < 1 || day > 31) {
-            return false;
-        }
-
-        if ((month == 4 || month == 6 || month == 9 || month == 11) && day > 30) {
-            return false;
-        }
 
-        if (month == 2) {
-            bool leapYear = (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0));
-            if (day > (leapYear ? 29 : 28)) {
-                return false;
-            }
-        }
-        
-        return true;
-    } catch (...) {
-        return false;
-    }
+    int year = parsed->civil().year;
+    return year >= 1900 && year <= 2100;
 }
 
 bool InputValidator::isValidTime(const std::string& time) {
@@ -0,0 +1,301 @@
+#include "../../include/services/journal_service.h"
+#include "../../include/services/logger.h"
+#include <filesystem>
+#include <iostream>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+using json = nlohmann::json;
+
+JournalService::JournalService(const std::string& journalFile)
+    : journalFilePath(journalFile),
+#ifndef _WIN32
+      journalFd(-1),
+#endif
+      lastSequence(0), recordCount(0) {
+}
+
+JournalService::~JournalService() {
+    closeFile();
+}
+
+void JournalService::closeFile() {
+#ifdef _WIN32
+    if (journalFile.is_open()) {
+        journalFile.close();
+    }
+#else
+    if (journalFd >= 0) {
+        ::close(journalFd);
+        journalFd = -1;
+    }
+#endif
+}
+
+bool JournalService::openForAppend() {
+#ifdef _WIN32
+    if (journalFile.is_open()) {
+        return true;
+    }
+
+    journalFile.open(journalFilePath, std::ios::app | std::ios::binary);
+    if (!journalFile.is_open()) {
+        Logger::getInstance().error("Не удалось открыть журнал изменений: " + journalFilePath);
+        return false;
+    }
+#else
+    if (journalFd >= 0) {
+        return true;
+    }
+
+    const bool created = !fs::exists(journalFilePath);
+    journalFd = ::open(journalFilePath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (journalFd < 0) {
+        Logger::getInstance().error("Не удалось открыть журнал изменений: " + journalFilePath);
+        return false;
+    }
+
+    // Если обрывок прошлой неудачной записи отрезать не удалось, новая запись
+    // начинается с новой строки, и при воспроизведении пропадет только обрывок.
+    struct stat status {};
+    char last = '\n';
+    if (::fstat(journalFd, &status) == 0 && status.st_size > 0 &&
+        ::pread(journalFd, &last, 1, status.st_size - 1) == 1 && last != '\n') {
+        if (::write(journalFd, "\n", 1) != 1) {
+            Logger::getInstance().error("Не удалось завершить оборванную запись журнала: " + journalFilePath);
+            closeFile();
+            return false;
+        }
+    }
+
+    // Новый файл журнала должен пережить сбой вместе со своей записью в каталоге.
+    if (created) {
+        fs::path directory = fs::path(journalFilePath).parent_path();
+        int dirFd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (dirFd >= 0) {
+            ::fsync(dirFd);
+            ::close(dirFd);
+        }
+    }
+#endif
+    return true;
+}
+
+bool JournalService::append(json record) {
+    if (!openForAppend()) {
+        return false;
+    }
+
+    const int64_t sequence = lastSequence + 1;
+    record["seq"] = sequence;
+    std::string line = record.dump();
+    line += '\n';
+
+#ifdef _WIN32
+    std::error_code sizeError;
+    const uintmax_t sizeBefore = fs::file_size(journalFilePath, sizeError);
+    journalFile.write(line.data(), static_cast<std::streamsize>(line.size()));
+    journalFile.flush();
+    if (!journalFile) {
+        Logger::getInstance().error("Ошибка записи в журнал изменений: " + journalFilePath);
+        closeFile();
+        if (!sizeError) {
+            fs::resize_file(journalFilePath, sizeBefore, sizeError);
+        }
+        return false;
+    }
+#else
+    // Неудачная запись не должна оставить в файле обрывок строки: следующая
+    // запись склеилась бы с ним и пропала при воспроизведении.
+    struct stat status {};
+    if (::fstat(journalFd, &status) != 0) {
+        Logger::getInstance().error("Не удалось определить размер журнала изменений: " + journalFilePath);
+        return false;
+    }
+    const off_t sizeBefore = status.st_size;
+
+    const char* cursor = line.data();
+    size_t remaining = line.size();
+    bool durable = true;
+    while (remaining > 0) {
+        ssize_t written = ::write(journalFd, cursor, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Logger::getInstance().error("Ошибка записи в журнал изменений: " + journalFilePath);
+            durable = false;
+            break;
+        }
+        cursor += written;
+        remaining -= static_cast<size_t>(written);
+    }
+
+    if (durable && ::fsync(journalFd) != 0) {
+        Logger::getInstance().error("Не удалось сбросить журнал изменений на диск: " + journalFilePath);
+        durable = false;
+    }
+
+    if (!durable) {
+        if (::ftruncate(journalFd, sizeBefore) != 0) {
+            Logger::getInstance().error("Не удалось отменить незавершенную запись журнала: " + journalFilePath);
+        }
+        closeFile();
+        return false;
+    }
+#endif
+
+    lastSequence = sequence;
+    recordCount++;
+    return true;
+}
+
+std::vector<std::pair<int64_t, std::string>> JournalService::listSegments() const {
+    std::vector<std::pair<int64_t, std::string>> segments;
+
+    fs::path journalPath(journalFilePath);
+    fs::path directory = journalPath.parent_path().empty() ? fs::path(".") : journalPath.parent_path();
+    const std::string prefix = journalPath.filename().string() + ".";
+
+    std::error_code error;
+    for (const auto& entry : fs::directory_iterator(directory, error)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+
+        const std::string suffix = name.substr(prefix.size());
+        if (suffix.find_first_not_of("0123456789") != std::string::npos) {
+            continue;
+        }
+        segments.emplace_back(std::stoll(suffix), entry.path().string());
+    }
+
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+size_t JournalService::replay(int64_t afterSequence, const std::function<void(const json&)>& apply) {
+    std::lock_guard<std::mutex> lock(segmentMutex);
+    lastSequence = std::max(lastSequence, afterSequence);
+
+    size_t applied = 0;
+    size_t segmentRecords = 0;
+    for (const auto& [sequence, filename] : listSegments()) {
+        applied += replayFile(filename, afterSequence, apply, segmentRecords);
+    }
+
+    recordCount = 0;
+    applied += replayFile(journalFilePath, afterSequence, apply, recordCount);
+    return applied;
+}
+
+size_t JournalService::replayFile(const std::string& filename, int64_t afterSequence,
+                                  const std::function<void(const json&)>& apply, size_t& records) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return 0;
+    }
+
+    size_t applied = 0;
+    std::streamoff validEnd = 0;
+    bool tornTail = false;
+    size_t lineNumber = 0;
+    std::string line;
+
+    while (std::getline(file, line)) {
+        lineNumber++;
+        // Строка без завершающего '\n' может быть только последней: запись оборвалась.
+        if (file.eof()) {
+            tornTail = true;
+            break;
+        }
+        validEnd = file.tellg();
+        if (line.empty()) {
+            continue;
+        }
+
+        // Поврежденная полная строка пропускается: записи после нее еще можно восстановить.
+        json record;
+        try {
+            record = json::parse(line);
+        } catch (const json::parse_error&) {
+            Logger::getInstance().error("Поврежденная запись журнала пропущена: " + filename + ", строка " +
+                                        std::to_string(lineNumber));
+            continue;
+        }
+        records++;
+
+        int64_t sequence = record.value("seq", static_cast<int64_t>(0));
+        if (sequence > lastSequence) {
+            lastSequence = sequence;
+        }
+        if (sequence <= afterSequence) {
+            continue;
+        }
+
+        try {
+            apply(record);
+            applied++;
+        } catch (const std::exception& e) {
+            Logger::getInstance().error("Ошибка при применении записи журнала #" + std::to_string(sequence) +
+                                        ": " + e.what());
+        }
+    }
+    file.close();
+
+    if (tornTail) {
+        Logger::getInstance().warning("Журнал изменений содержит незавершенную запись, она будет отброшена: " +
+                                      filename);
+        try {
+            fs::resize_file(filename, static_cast<uintmax_t>(validEnd));
+        } catch (const std::exception& e) {
+            Logger::getInstance().error("Не удалось обрезать журнал изменений: " + std::string(e.what()));
+        }
+    }
+
+    return applied;
+}
+
+bool JournalService::rotate() {
+    std::lock_guard<std::mutex> lock(segmentMutex);
+
+    closeFile();
+    recordCount = 0;
+
+    if (!fs::exists(journalFilePath)) {
+        return true;
+    }
+
+    std::error_code error;
+    fs::rename(journalFilePath, journalFilePath + "." + std::to_string(lastSequence), error);
+    if (error) {
+        Logger::getInstance().error("Не удалось закрыть сегмент журнала изменений: " + error.message());
+        return false;
+    }
+    return true;
+}
+
+void JournalService::removeSegmentsUpTo(int64_t sequence) {
+    std::lock_guard<std::mutex> lock(segmentMutex);
+
+    for (const auto& [segmentSequence, filename] : listSegments()) {
+        if (segmentSequence > sequence) {
+            break;
+        }
+
+        std::error_code error;
+        fs::remove(filename, error);
+        if (error) {
+            Logger::getInstance().warning("Не удалось удалить сегмент журнала " + filename + ": " + error.message());
+        }
+    }
+}
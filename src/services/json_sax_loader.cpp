@@ -0,0 +1,227 @@
+#include "../../include/services/json_sax_loader.h"
+
+using Schema::JsonScalar;
+
+namespace {
+
+// Элементы массива задач. Каждый объект разбирается TaskTreeSink.
+class TaskListSink : public Schema::SaxSink {
+private:
+    std::function<void(Task&&)> emit;
+
+public:
+    explicit TaskListSink(std::function<void(Task&&)> emit) : emit(std::move(emit)) {}
+
+    std::unique_ptr<Schema::SaxSink> nested(bool array) override;
+};
+
+// Задача по таблице полей. Вложенный список "subtasks" старого формата
+// разворачивается: подзадачи выдаются сразу после родителя с заполненным parentId.
+class TaskTreeSink : public Schema::SaxSink {
+private:
+    Task task;
+    std::vector<Task> subtasks;
+    std::unique_ptr<Schema::SaxSink> fields;
+    std::function<void(Task&&)> emit;
+    bool subtasksKey = false;
+
+public:
+    explicit TaskTreeSink(std::function<void(Task&&)> emit)
+        : fields(Schema::makeSink<Task>(false, [this](Task&& value) { task = std::move(value); })),
+          emit(std::move(emit)) {}
+
+    void key(std::string& name) override {
+        subtasksKey = name == "subtasks";
+        fields->key(name);
+    }
+
+    void scalar(JsonScalar& value) override { fields->scalar(value); }
+
+    std::unique_ptr<Schema::SaxSink> nested(bool array) override {
+        if (!subtasksKey) {
+            return fields->nested(array);
+        }
+        if (!array) {
+            return nullptr;
+        }
+        return std::make_unique<TaskListSink>([this](Task&& subtask) { subtasks.push_back(std::move(subtask)); });
+    }
+
+    void close() override {
+        fields->close();
+        int parentId = task.getId();
+        emit(std::move(task));
+        for (auto& subtask : subtasks) {
+            if (!subtask.isSubtask()) {
+                subtask.setParentId(parentId);
+            }
+            emit(std::move(subtask));
+        }
+    }
+};
+
+std::unique_ptr<Schema::SaxSink> TaskListSink::nested(bool array) {
+    if (array) {
+        return nullptr;
+    }
+    return std::make_unique<TaskTreeSink>(emit);
+}
+
+}
+
+class JsonSaxLoader::DocumentSink : public Schema::SaxSink {
+private:
+    JsonSaxLoader& loader;
+    std::string currentKey;
+
+public:
+    explicit DocumentSink(JsonSaxLoader& loader) : loader(loader) {}
+
+    void key(std::string& name) override { currentKey.assign(name); }
+
+    void scalar(JsonScalar& value) override {
+        if (currentKey == "journalSequence" && value.kind == JsonScalar::Kind::Integer) {
+            loader.journalSequence = value.integer;
+        }
+    }
+
+    std::unique_ptr<Schema::SaxSink> nested(bool array) override {
+        if (currentKey == "tasks") {
+            if (!array) {
+                return nullptr;
+            }
+            loader.tasks.clear();
+            return std::make_unique<TaskListSink>([this](Task&& task) { loader.tasks.push_back(std::move(task)); });
+        }
+        if (currentKey == "reminders") {
+            return Schema::makeSink<std::vector<Reminder>>(array, [this](std::vector<Reminder>&& values) {
+                *loader.reminders = std::move(values);
+            });
+        }
+        if (currentKey == "templates") {
+            return Schema::makeSink<std::vector<TaskTemplate>>(array, [this](std::vector<TaskTemplate>&& values) {
+                for (auto& templ : values) {
+                    std::string name = templ.getName();
+                    (*loader.templates)[name] = std::move(templ);
+                }
+            });
+        }
+        return nullptr;
+    }
+};
+
+JsonSaxLoader::JsonSaxLoader(std::vector<Task>& tasks,
+                             std::vector<Reminder>& reminders,
+                             std::map<std::string, TaskTemplate>& templates)
+    : tasks(tasks), reminders(&reminders), templates(&templates), journalSequence(0) {
+}
+
+JsonSaxLoader::JsonSaxLoader(std::vector<Task>& tasks)
+    : tasks(tasks), reminders(nullptr), templates(nullptr), journalSequence(0) {
+}
+
+JsonSaxLoader::~JsonSaxLoader() = default;
+
+bool JsonSaxLoader::scalar(JsonScalar& value) {
+    if (!sinks.empty() && sinks.back()) {
+        sinks.back()->scalar(value);
+    }
+    return true;
+}
+
+bool JsonSaxLoader::open(bool array) {
+    if (sinks.empty()) {
+        if (array) {
+            sinks.push_back(nullptr);
+        } else if (!reminders) {
+            sinks.push_back(std::make_unique<TaskTreeSink>([this](Task&& task) {
+                tasks.push_back(std::move(task));
+            }));
+        } else {
+            sinks.push_back(std::make_unique<DocumentSink>(*this));
+        }
+        return true;
+    }
+
+    Schema::SaxSink* parent = sinks.back().get();
+    sinks.push_back(parent ? parent->nested(array) : nullptr);
+    return true;
+}
+
+bool JsonSaxLoader::close() {
+    if (sinks.back()) {
+        sinks.back()->close();
+    }
+    sinks.pop_back();
+    return true;
+}
+
+bool JsonSaxLoader::null() {
+    JsonScalar value;
+    return scalar(value);
+}
+
+bool JsonSaxLoader::boolean(bool value) {
+    JsonScalar scalarValue;
+    scalarValue.kind = JsonScalar::Kind::Boolean;
+    scalarValue.boolean = value;
+    return scalar(scalarValue);
+}
+
+bool JsonSaxLoader::number_integer(number_integer_t value) {
+    JsonScalar scalarValue;
+    scalarValue.kind = JsonScalar::Kind::Integer;
+    scalarValue.integer = value;
+    return scalar(scalarValue);
+}
+
+bool JsonSaxLoader::number_unsigned(number_unsigned_t value) {
+    return number_integer(static_cast<number_integer_t>(value));
+}
+
+bool JsonSaxLoader::number_float(number_float_t value, const string_t&) {
+    JsonScalar scalarValue;
+    scalarValue.kind = JsonScalar::Kind::Float;
+    scalarValue.number = value;
+    return scalar(scalarValue);
+}
+
+bool JsonSaxLoader::string(string_t& value) {
+    JsonScalar scalarValue;
+    scalarValue.kind = JsonScalar::Kind::String;
+    scalarValue.text = &value;
+    return scalar(scalarValue);
+}
+
+bool JsonSaxLoader::binary(binary_t&) {
+    return true;
+}
+
+bool JsonSaxLoader::start_object(std::size_t) {
+    return open(false);
+}
+
+bool JsonSaxLoader::key(string_t& value) {
+    if (sinks.back()) {
+        sinks.back()->key(value);
+    }
+    return true;
+}
+
+bool JsonSaxLoader::end_object() {
+    return close();
+}
+
+bool JsonSaxLoader::start_array(std::size_t) {
+    return open(true);
+}
+
+bool JsonSaxLoader::end_array() {
+    return close();
+}
+
+bool JsonSaxLoader::parse_error(std::size_t position, const std::string& lastToken,
+                                const nlohmann::detail::exception& ex) {
+    errorMessage = "позиция " + std::to_string(position) + ", токен '" + lastToken + "': " + ex.what();
+    return false;
+}
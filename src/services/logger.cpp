@@ -1,4 +1,5 @@
 #include "../../include/services/logger.h"
+#include "../../include/services/clock.h"
 #include <iostream>
 #include <chrono>
 #include <ctime>
@@ -94,18 +95,7 @@ std::string Logger::levelToString(LogLevel level) {
 }
 
 std::string Logger::getCurrentTimeAsString() {
-    auto now = std::chrono::system_clock::now();
-    auto now_time_t = std::chrono::system_clock::to_time_t(now);
-    std::tm* now_tm = std::localtime(&now_time_t);
-
-    auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                      now.time_since_epoch()) % 1000;
-
-    std::stringstream timeStream;
-    timeStream << std::put_time(now_tm, "%Y-%m-%d %H:%M:%S")
-               << '.' << std::setfill('0') << std::setw(3) << now_ms.count();
-    
-    return timeStream.str();
+    return Clock::formatMillis(Clock::now());
 }
 
 void Logger::writeLogMessage(const std::string& formattedMessage) {
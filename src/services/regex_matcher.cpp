@@ -0,0 +1,648 @@
+#include "../../include/services/regex_matcher.h"
+#include "../../include/models/case_folding.h"
+#include <algorithm>
+#include <cctype>
+#include <list>
+#include <mutex>
+#include <utility>
+
+namespace {
+
+constexpr size_t MAX_NFA_STATES = 20000;
+constexpr int MAX_REPEAT = 1000;
+constexpr int INFINITE = -1;
+
+unsigned char foldCase(unsigned char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+}
+
+// Выражение для поиска без учета регистра: буквы литералов и классов
+// складываются так же, как текст (CaseFolding), а экранированные ASCII-символы
+// остаются как есть, чтобы \D, \W, \S и \B не превратились в \d, \w, \s и \b.
+std::string foldPattern(const std::string& pattern) {
+    std::string folded = pattern;
+    size_t start = 0;
+    for (size_t i = 0; i + 1 < folded.size(); ++i) {
+        if (folded[i] == '\\' && static_cast<unsigned char>(folded[i + 1]) < 0x80) {
+            CaseFolding::foldInPlace(folded.data() + start, i - start);
+            i++;
+            start = i + 1;
+        }
+    }
+    if (start < folded.size()) {
+        CaseFolding::foldInPlace(folded.data() + start, folded.size() - start);
+    }
+    return folded;
+}
+
+std::bitset<256> classBits(char name) {
+    std::bitset<256> bits;
+    for (int c = 0; c < 128; ++c) {
+        bool member = false;
+        switch (name) {
+            case 'd': member = c >= '0' && c <= '9'; break;
+            case 'w': member = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; break;
+            case 's': member = c == ' ' || (c >= '\t' && c <= '\r'); break;
+        }
+        bits[c] = member;
+    }
+    return bits;
+}
+
+// Разбор выражения в дерево. Конструкции, которых нет в ДКА, и все, что
+// разбирается неоднозначно, помечаются как неподдерживаемые.
+class Parser {
+public:
+    struct Node {
+        enum Kind { Empty, Set, Begin, End, Concat, Alternate, Repeat };
+        Kind kind = Empty;
+        std::bitset<256> bits{};
+        std::vector<int> children{};
+        bool negated = false;
+        int min = 0;
+        int max = 0;
+    };
+
+    std::vector<Node> nodes;
+    bool supported = true;
+
+    explicit Parser(const std::string& pattern) : pattern(pattern), pos(0) {}
+
+    int parse() {
+        int root = parseAlternation();
+        if (pos != pattern.size()) {
+            supported = false;
+        }
+        return root;
+    }
+
+private:
+    const std::string& pattern;
+    size_t pos;
+
+    bool atEnd() const { return pos >= pattern.size(); }
+    char peek() const { return pattern[pos]; }
+
+    int add(Node node) {
+        nodes.push_back(std::move(node));
+        return static_cast<int>(nodes.size()) - 1;
+    }
+
+    int addSet(const std::bitset<256>& bits) {
+        Node node{Node::Set};
+        node.bits = bits;
+        return add(std::move(node));
+    }
+
+    int parseAlternation() {
+        std::vector<int> branches{parseConcat()};
+        while (supported && !atEnd() && peek() == '|') {
+            pos++;
+            branches.push_back(parseConcat());
+        }
+        if (branches.size() == 1) {
+            return branches.front();
+        }
+        Node node{Node::Alternate};
+        node.children = std::move(branches);
+        return add(std::move(node));
+    }
+
+    int parseConcat() {
+        std::vector<int> items;
+        while (supported && !atEnd() && peek() != '|' && peek() != ')') {
+            items.push_back(parseRepeat());
+        }
+        if (items.size() == 1) {
+            return items.front();
+        }
+        Node node{items.empty() ? Node::Empty : Node::Concat};
+        node.children = std::move(items);
+        return add(std::move(node));
+    }
+
+    bool parseNumber(int& value) {
+        size_t start = pos;
+        value = 0;
+        while (!atEnd() && peek() >= '0' && peek() <= '9') {
+            value = value * 10 + (peek() - '0');
+            if (value > MAX_REPEAT) {
+                return false;
+            }
+            pos++;
+        }
+        return pos > start;
+    }
+
+    int parseRepeat() {
+        int atom = parseAtom();
+        if (!supported || atEnd()) {
+            return atom;
+        }
+
+        int min = 0;
+        int max = 0;
+        switch (peek()) {
+            case '*': min = 0; max = INFINITE; pos++; break;
+            case '+': min = 1; max = INFINITE; pos++; break;
+            case '?': min = 0; max = 1; pos++; break;
+            case '{': {
+                pos++;
+                if (!parseNumber(min)) {
+                    supported = false;
+                    return atom;
+                }
+                max = min;
+                if (!atEnd() && peek() == ',') {
+                    pos++;
+                    max = INFINITE;
+                    if (!atEnd() && peek() != '}' && (!parseNumber(max) || max < min)) {
+                        supported = false;
+                        return atom;
+                    }
+                }
+                if (atEnd() || peek() != '}') {
+                    supported = false;
+                    return atom;
+                }
+                pos++;
+                break;
+            }
+            default:
+                return atom;
+        }
+
+        if (!atEnd() && peek() == '?') {
+            pos++;
+        }
+        if (!atEnd() && (peek() == '*' || peek() == '+' || peek() == '?' || peek() == '{')) {
+            supported = false;
+            return atom;
+        }
+
+        Node node{Node::Repeat};
+        node.children = {atom};
+        node.min = min;
+        node.max = max;
+        return add(std::move(node));
+    }
+
+    // Экранированный символ после '\'. false для конструкций без ДКА.
+    bool parseEscape(bool inClass, std::bitset<256>& bits) {
+        if (atEnd()) {
+            return false;
+        }
+        char c = pattern[pos++];
+        switch (c) {
+            case 'd': case 'w': case 's':
+                bits |= classBits(c);
+                return true;
+            case 'D': case 'W': case 'S':
+                bits |= ~classBits(static_cast<char>(c - 'A' + 'a'));
+                return true;
+            case 'f': bits.set('\f'); return true;
+            case 'n': bits.set('\n'); return true;
+            case 'r': bits.set('\r'); return true;
+            case 't': bits.set('\t'); return true;
+            case 'v': bits.set('\v'); return true;
+            case '0':
+                if (!atEnd() && peek() >= '0' && peek() <= '9') {
+                    return false;
+                }
+                bits.set(0);
+                return true;
+            case 'x': {
+                if (pos + 2 > pattern.size() || !std::isxdigit(static_cast<unsigned char>(pattern[pos])) ||
+                    !std::isxdigit(static_cast<unsigned char>(pattern[pos + 1]))) {
+                    return false;
+                }
+                bits.set(std::stoi(pattern.substr(pos, 2), nullptr, 16));
+                pos += 2;
+                return true;
+            }
+            case 'b':
+                if (inClass) {
+                    bits.set('\b');
+                    return true;
+                }
+                return false;
+            default:
+                if (std::isalnum(static_cast<unsigned char>(c))) {
+                    return false;
+                }
+                bits.set(static_cast<unsigned char>(c));
+                return true;
+        }
+    }
+
+    // Один символ класса: обычный или экранированный. count - сколько
+    // символов он задает (для проверки границ диапазона).
+    bool parseClassAtom(std::bitset<256>& bits, size_t& count) {
+        if (peek() == '\\') {
+            pos++;
+            std::bitset<256> escaped;
+            if (!parseEscape(true, escaped)) {
+                return false;
+            }
+            bits |= escaped;
+            count = escaped.count();
+            return true;
+        }
+        if (peek() == '[' && pos + 1 < pattern.size() &&
+            (pattern[pos + 1] == ':' || pattern[pos + 1] == '.' || pattern[pos + 1] == '=')) {
+            return false;
+        }
+        bits.set(static_cast<unsigned char>(pattern[pos++]));
+        count = 1;
+        return true;
+    }
+
+    int parseClass() {
+        Node node{Node::Set};
+        bool negated = false;
+        if (!atEnd() && peek() == '^') {
+            negated = true;
+            pos++;
+        }
+        if (atEnd() || peek() == ']') {
+            supported = false;
+            return add(std::move(node));
+        }
+
+        while (!atEnd() && peek() != ']') {
+            std::bitset<256> low;
+            size_t lowCount = 0;
+            if (!parseClassAtom(low, lowCount)) {
+                supported = false;
+                return add(std::move(node));
+            }
+
+            if (pos + 1 < pattern.size() && peek() == '-' && pattern[pos + 1] != ']') {
+                pos++;
+                std::bitset<256> high;
+                size_t highCount = 0;
+                if (!parseClassAtom(high, highCount) || lowCount != 1 || highCount != 1) {
+                    supported = false;
+                    return add(std::move(node));
+                }
+
+                int from = 0;
+                int to = 0;
+                while (!low[from]) from++;
+                while (!high[to]) to++;
+                // Диапазоны за пределами ASCII std::regex сравнивает как знаковые char.
+                if (from > to || to >= 128) {
+                    supported = false;
+                    return add(std::move(node));
+                }
+                for (int c = from; c <= to; ++c) {
+                    node.bits.set(c);
+                }
+            } else {
+                node.bits |= low;
+            }
+        }
+
+        if (atEnd()) {
+            supported = false;
+            return add(std::move(node));
+        }
+        pos++;
+
+        node.negated = negated;
+        return add(std::move(node));
+    }
+
+    int parseAtom() {
+        char c = pattern[pos++];
+        switch (c) {
+            case '(': {
+                if (!atEnd() && peek() == '?') {
+                    if (pos + 1 < pattern.size() && pattern[pos + 1] == ':') {
+                        pos += 2;
+                    } else {
+                        supported = false;
+                        return add(Node{Node::Empty});
+                    }
+                }
+                int inner = parseAlternation();
+                if (atEnd() || peek() != ')') {
+                    supported = false;
+                    return inner;
+                }
+                pos++;
+                return inner;
+            }
+            case '[':
+                return parseClass();
+            case '.': {
+                std::bitset<256> bits;
+                bits.set('\n');
+                bits.set('\r');
+                Node node{Node::Set};
+                node.bits = bits;
+                node.negated = true;
+                return add(std::move(node));
+            }
+            case '^':
+                return add(Node{Node::Begin});
+            case '$':
+                return add(Node{Node::End});
+            case '\\': {
+                std::bitset<256> bits;
+                if (!parseEscape(false, bits)) {
+                    supported = false;
+                }
+                return addSet(bits);
+            }
+            case '*': case '+': case '?': case '{': case ')':
+                supported = false;
+                return add(Node{Node::Empty});
+            default: {
+                std::bitset<256> bits;
+                bits.set(static_cast<unsigned char>(c));
+                return addSet(bits);
+            }
+        }
+    }
+};
+
+}
+
+RegexMatcher::RegexMatcher(const std::string& pattern, bool caseSensitive)
+    : caseSensitive(caseSensitive), nfaStart(0), matchesEmpty(false), dfaStart(UNKNOWN), visitGeneration(0) {
+    std::regex validated(pattern, caseSensitive ? std::regex_constants::ECMAScript : std::regex_constants::icase);
+    if (!buildNfa(caseSensitive ? pattern : foldPattern(pattern))) {
+        fallback = std::move(validated);
+        nfa.clear();
+        sets.clear();
+    }
+}
+
+bool RegexMatcher::buildNfa(const std::string& pattern) {
+    Parser parser(pattern);
+    int root = parser.parse();
+    if (!parser.supported) {
+        return false;
+    }
+
+    auto addState = [this](NfaState::Type type, int set, int out, int out1) {
+        nfa.push_back({type, set, out, out1});
+        return static_cast<int>(nfa.size()) - 1;
+    };
+
+    // Состояния строятся с конца: compile(node, next) возвращает вход в
+    // фрагмент узла, выход которого ведет в next.
+    bool tooLarge = false;
+    auto compile = [&](auto&& self, int index, int next) -> int {
+        if (tooLarge || nfa.size() > MAX_NFA_STATES) {
+            tooLarge = true;
+            return next;
+        }
+
+        const Parser::Node& node = parser.nodes[index];
+        switch (node.kind) {
+            case Parser::Node::Empty:
+                return next;
+            case Parser::Node::Set: {
+                // Отрицание - после приведения регистра, как в std::regex.
+                std::bitset<256> bits = node.bits;
+                if (!caseSensitive) {
+                    std::bitset<256> folded;
+                    for (int c = 0; c < 256; ++c) {
+                        if (bits[c]) {
+                            folded.set(foldCase(static_cast<unsigned char>(c)));
+                        }
+                    }
+                    bits = folded;
+                }
+                if (node.negated) {
+                    bits.flip();
+                }
+                sets.push_back(bits);
+                return addState(NfaState::Byte, static_cast<int>(sets.size()) - 1, next, UNKNOWN);
+            }
+            case Parser::Node::Begin:
+                return addState(NfaState::Begin, UNKNOWN, next, UNKNOWN);
+            case Parser::Node::End:
+                return addState(NfaState::End, UNKNOWN, next, UNKNOWN);
+            case Parser::Node::Concat:
+                for (auto it = node.children.rbegin(); it != node.children.rend(); ++it) {
+                    next = self(self, *it, next);
+                }
+                return next;
+            case Parser::Node::Alternate: {
+                int entry = self(self, node.children.back(), next);
+                for (size_t i = node.children.size() - 1; i-- > 0;) {
+                    int branch = self(self, node.children[i], next);
+                    entry = addState(NfaState::Split, UNKNOWN, branch, entry);
+                }
+                return entry;
+            }
+            case Parser::Node::Repeat: {
+                int child = node.children.front();
+                int min = node.min;
+                int max = node.max;
+                int tail = next;
+                if (max == INFINITE) {
+                    int loop = addState(NfaState::Split, UNKNOWN, UNKNOWN, next);
+                    int body = self(self, child, loop);
+                    nfa[loop].out = body;
+                    tail = loop;
+                } else {
+                    for (int i = min; i < max; ++i) {
+                        int body = self(self, child, tail);
+                        tail = addState(NfaState::Split, UNKNOWN, body, tail);
+                    }
+                }
+                for (int i = 0; i < min; ++i) {
+                    tail = self(self, child, tail);
+                }
+                return tail;
+            }
+        }
+        return next;
+    };
+
+    int match = addState(NfaState::Match, UNKNOWN, UNKNOWN, UNKNOWN);
+    nfaStart = compile(compile, root, match);
+    if (tooLarge) {
+        return false;
+    }
+
+    visitMarks.assign(nfa.size(), 0);
+    std::vector<int> stack{nfaStart};
+    std::vector<int> states;
+    closure(stack, true, true, states);
+    matchesEmpty = std::any_of(states.begin(), states.end(), [&](int s) { return nfa[s].type == NfaState::Match; });
+    return true;
+}
+
+void RegexMatcher::closure(std::vector<int>& stack, bool atBegin, bool atEnd, std::vector<int>& result) {
+    visitGeneration++;
+    result.clear();
+    while (!stack.empty()) {
+        int state = stack.back();
+        stack.pop_back();
+        if (state == UNKNOWN || visitMarks[state] == visitGeneration) {
+            continue;
+        }
+        visitMarks[state] = visitGeneration;
+
+        const NfaState& current = nfa[state];
+        switch (current.type) {
+            case NfaState::Byte:
+            case NfaState::Match:
+                result.push_back(state);
+                break;
+            case NfaState::Split:
+                stack.push_back(current.out1);
+                stack.push_back(current.out);
+                break;
+            case NfaState::Begin:
+                if (atBegin) {
+                    stack.push_back(current.out);
+                }
+                break;
+            case NfaState::End:
+                // Без конца текста условие откладывается до последнего байта.
+                if (atEnd) {
+                    stack.push_back(current.out);
+                } else {
+                    result.push_back(state);
+                }
+                break;
+        }
+    }
+    std::sort(result.begin(), result.end());
+}
+
+int RegexMatcher::dfaState(std::vector<int> states) {
+    auto it = dfaIndex.find(states);
+    if (it != dfaIndex.end()) {
+        return it->second;
+    }
+
+    // Слишком большой автомат строится заново с текущего состояния.
+    if (dfa.size() >= MAX_DFA_STATES) {
+        dfa.clear();
+        dfaIndex.clear();
+        dfaStart = UNKNOWN;
+    }
+
+    DfaState state;
+    state.match = false;
+    std::vector<int> pending;
+    for (int s : states) {
+        if (nfa[s].type == NfaState::Match) {
+            state.match = true;
+        } else if (nfa[s].type == NfaState::End) {
+            pending.push_back(s);
+        }
+    }
+
+    std::vector<int> atEnd;
+    for (int& s : pending) {
+        s = nfa[s].out;
+    }
+    closure(pending, false, true, atEnd);
+    state.matchAtEnd = state.match ||
+                       std::any_of(atEnd.begin(), atEnd.end(), [&](int s) { return nfa[s].type == NfaState::Match; });
+    state.next.fill(UNKNOWN);
+    state.nfa = states;
+
+    dfa.push_back(std::move(state));
+    int index = static_cast<int>(dfa.size()) - 1;
+    dfaIndex.emplace(std::move(states), index);
+    return index;
+}
+
+int RegexMatcher::step(int state, unsigned char byte) {
+    std::vector<int> stack;
+    for (int s : dfa[state].nfa) {
+        if (nfa[s].type == NfaState::Byte && sets[nfa[s].set][byte]) {
+            stack.push_back(nfa[s].out);
+        }
+    }
+    // Совпадение может начаться с любой позиции.
+    stack.push_back(nfaStart);
+
+    std::vector<int> states;
+    closure(stack, false, false, states);
+
+    size_t before = dfa.size();
+    int target = dfaState(std::move(states));
+    if (dfa.size() >= before) {
+        dfa[state].next[byte] = target;
+    }
+    return target;
+}
+
+bool RegexMatcher::search(std::string_view text) {
+    if (fallback) {
+        return std::regex_search(text.begin(), text.end(), *fallback);
+    }
+    if (!caseSensitive) {
+        return searchFolded(CaseFolding::foldInto(text, foldBuffer));
+    }
+    return searchFolded(text);
+}
+
+bool RegexMatcher::searchFolded(std::string_view text) {
+    if (fallback) {
+        return std::regex_search(text.begin(), text.end(), *fallback);
+    }
+    if (text.empty()) {
+        return matchesEmpty;
+    }
+
+    if (dfaStart == UNKNOWN) {
+        std::vector<int> stack{nfaStart};
+        std::vector<int> states;
+        closure(stack, true, false, states);
+        dfaStart = dfaState(std::move(states));
+    }
+
+    int state = dfaStart;
+    for (char c : text) {
+        if (dfa[state].match) {
+            return true;
+        }
+        // Пустое множество бывает только у выражения с ^: совпадений дальше нет.
+        if (dfa[state].nfa.empty()) {
+            return false;
+        }
+        unsigned char byte = static_cast<unsigned char>(c);
+        int next = dfa[state].next[byte];
+        state = next != UNKNOWN ? next : step(state, byte);
+    }
+    return dfa[state].matchAtEnd;
+}
+
+std::shared_ptr<RegexMatcher> RegexMatcher::compile(const std::string& pattern, bool caseSensitive) {
+    static constexpr size_t CACHE_SIZE = 16;
+    static std::mutex cacheMutex;
+    static std::list<std::pair<std::string, std::shared_ptr<RegexMatcher>>> cache;
+
+    std::string key = (caseSensitive ? "1" : "0") + pattern;
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    for (auto it = cache.begin(); it != cache.end(); ++it) {
+        if (it->first == key) {
+            cache.splice(cache.begin(), cache, it);
+            return cache.front().second;
+        }
+    }
+
+    // Некорректное выражение тоже запоминается, как пустой указатель.
+    std::shared_ptr<RegexMatcher> matcher;
+    try {
+        matcher.reset(new RegexMatcher(pattern, caseSensitive));
+    } catch (const std::regex_error&) {
+    }
+
+    cache.emplace_front(std::move(key), matcher);
+    if (cache.size() > CACHE_SIZE) {
+        cache.pop_back();
+    }
+    return matcher;
+}
@@ -0,0 +1,332 @@
+#include "../../include/services/schema_codec.h"
+#include "../../include/services/clock.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace Schema {
+
+std::string formatTime(TimePoint time) {
+    return Clock::formatMinute(time);
+}
+
+TimePoint parseTime(const std::string& text) {
+    std::tm tm = {};
+    std::istringstream ss(text);
+    ss >> std::get_time(&tm, "%Y-%m-%d %H:%M");
+    tm.tm_isdst = -1;
+    return std::chrono::system_clock::from_time_t(std::mktime(&tm));
+}
+
+namespace {
+
+size_t utf8SequenceLength(std::string_view text, size_t pos) {
+    auto byte = [&](size_t i) { return static_cast<unsigned char>(text[i]); };
+    auto continuation = [&](size_t i, unsigned char low, unsigned char high) {
+        return i < text.size() && byte(i) >= low && byte(i) <= high;
+    };
+
+    unsigned char lead = byte(pos);
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        return continuation(pos + 1, 0x80, 0xBF) ? 2 : 0;
+    }
+    if (lead >= 0xE0 && lead <= 0xEF) {
+        unsigned char low = lead == 0xE0 ? 0xA0 : 0x80;
+        unsigned char high = lead == 0xED ? 0x9F : 0xBF;
+        return continuation(pos + 1, low, high) && continuation(pos + 2, 0x80, 0xBF) ? 3 : 0;
+    }
+    if (lead >= 0xF0 && lead <= 0xF4) {
+        unsigned char low = lead == 0xF0 ? 0x90 : 0x80;
+        unsigned char high = lead == 0xF4 ? 0x8F : 0xBF;
+        return continuation(pos + 1, low, high) && continuation(pos + 2, 0x80, 0xBF) &&
+               continuation(pos + 3, 0x80, 0xBF) ? 4 : 0;
+    }
+    return 0;
+}
+
+void appendEscaped(std::string& out, std::string_view text) {
+    static const char hex[] = "0123456789abcdef";
+
+    out.push_back('"');
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t run = pos;
+        while (run < text.size()) {
+            auto c = static_cast<unsigned char>(text[run]);
+            if (c < 0x20 || c == '"' || c == '\\' || c >= 0x80) {
+                break;
+            }
+            run++;
+        }
+        out.append(text.data() + pos, run - pos);
+        pos = run;
+        if (pos == text.size()) {
+            break;
+        }
+
+        auto c = static_cast<unsigned char>(text[pos]);
+        if (c >= 0x80) {
+            size_t length = utf8SequenceLength(text, pos);
+            if (length == 0) {
+                out.append("\xEF\xBF\xBD");
+                pos++;
+            } else {
+                out.append(text.data() + pos, length);
+                pos += length;
+            }
+            continue;
+        }
+
+        switch (c) {
+            case '"': out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\b': out.append("\\b"); break;
+            case '\f': out.append("\\f"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            default:
+                out.append("\\u00");
+                out.push_back(hex[c >> 4]);
+                out.push_back(hex[c & 0x0F]);
+        }
+        pos++;
+    }
+    out.push_back('"');
+}
+
+}
+
+JsonWriter::JsonWriter(std::string& out, int indent) : out(out), indent(indent), afterKey(false) {
+}
+
+void JsonWriter::newline() {
+    out.push_back('\n');
+    out.append(emptyScopes.size() * static_cast<size_t>(indent), ' ');
+}
+
+void JsonWriter::element() {
+    if (afterKey) {
+        afterKey = false;
+        return;
+    }
+    if (emptyScopes.empty()) {
+        return;
+    }
+    if (!emptyScopes.back()) {
+        out.push_back(',');
+    }
+    emptyScopes.back() = false;
+    newline();
+}
+
+void JsonWriter::beginObject() {
+    element();
+    out.push_back('{');
+    emptyScopes.push_back(true);
+}
+
+void JsonWriter::endObject() {
+    bool wasEmpty = emptyScopes.back();
+    emptyScopes.pop_back();
+    if (!wasEmpty) {
+        newline();
+    }
+    out.push_back('}');
+}
+
+void JsonWriter::beginArray() {
+    element();
+    out.push_back('[');
+    emptyScopes.push_back(true);
+}
+
+void JsonWriter::endArray() {
+    bool wasEmpty = emptyScopes.back();
+    emptyScopes.pop_back();
+    if (!wasEmpty) {
+        newline();
+    }
+    out.push_back(']');
+}
+
+void JsonWriter::key(std::string_view name) {
+    element();
+    appendEscaped(out, name);
+    out.append(": ");
+    afterKey = true;
+}
+
+void JsonWriter::string(std::string_view value) {
+    element();
+    appendEscaped(out, value);
+}
+
+void JsonWriter::integer(int64_t value) {
+    element();
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void JsonWriter::number(double value) {
+    element();
+    if (!std::isfinite(value)) {
+        out.append("null");
+        return;
+    }
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void JsonWriter::boolean(bool value) {
+    element();
+    out.append(value ? "true" : "false");
+}
+
+StringTable::StringTable() : offsets{0} {
+}
+
+uint32_t StringTable::add(const std::string& value) {
+    if (value.empty()) {
+        return 0;
+    }
+
+    auto it = ids.find(value);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    if (bytes.size() + value.size() > UINT32_MAX) {
+        throw std::length_error("таблица строк снимка превышает 4 ГБ");
+    }
+
+    bytes += value;
+    offsets.push_back(static_cast<uint32_t>(bytes.size()));
+    auto id = static_cast<uint32_t>(offsets.size() - 1);
+    ids.emplace(value, id);
+    return id;
+}
+
+void BinaryWriter::unsignedVarint(uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void BinaryWriter::signedVarint(int64_t value) {
+    unsignedVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+BinaryReader::BinaryReader(const char* begin, const char* end,
+                           const char* stringBytes, uint64_t stringBytesSize,
+                           const char* stringOffsets, uint32_t stringCount)
+    : cursor(begin), end(end), stringBytes(stringBytes), stringBytesSize(stringBytesSize),
+      stringOffsets(stringOffsets), stringCount(stringCount) {
+}
+
+uint64_t BinaryReader::unsignedVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (cursor == end) {
+            throw std::runtime_error("поврежденный снимок: запись выходит за границы секции");
+        }
+        auto byte = static_cast<uint8_t>(*cursor++);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw std::runtime_error("поврежденный снимок: слишком длинное число");
+}
+
+int64_t BinaryReader::signedVarint() {
+    uint64_t value = unsignedVarint();
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+uint8_t BinaryReader::byte() {
+    if (cursor == end) {
+        throw std::runtime_error("поврежденный снимок: запись выходит за границы секции");
+    }
+    return static_cast<uint8_t>(*cursor++);
+}
+
+std::string BinaryReader::string() {
+    return std::string(stringView());
+}
+
+std::string_view BinaryReader::stringView() {
+    return stringAt(unsignedVarint());
+}
+
+std::string_view BinaryReader::stringAt(uint64_t id) const {
+    if (id == 0) {
+        return {};
+    }
+    if (id > stringCount) {
+        throw std::runtime_error("поврежденный снимок: ссылка за пределами таблицы строк");
+    }
+
+    uint32_t begin = 0;
+    uint32_t finish = 0;
+    std::memcpy(&begin, stringOffsets + (id - 1) * sizeof(uint32_t), sizeof(uint32_t));
+    std::memcpy(&finish, stringOffsets + id * sizeof(uint32_t), sizeof(uint32_t));
+    if (begin > finish || finish > stringBytesSize) {
+        throw std::runtime_error("поврежденный снимок: неверная запись таблицы строк");
+    }
+    return std::string_view(stringBytes + begin, finish - begin);
+}
+
+std::string joinList(const std::vector<std::string>& values) {
+    std::string result;
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i > 0) {
+            result.push_back(';');
+        }
+        for (char c : values[i]) {
+            if (c == ';' || c == '\\') {
+                result.push_back('\\');
+            }
+            result.push_back(c);
+        }
+    }
+    return result;
+}
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> values;
+    if (text.empty()) {
+        return values;
+    }
+
+    std::string current;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\\' && i + 1 < text.size()) {
+            current.push_back(text[++i]);
+        } else if (text[i] == ';') {
+            values.push_back(std::move(current));
+            current.clear();
+        } else {
+            current.push_back(text[i]);
+        }
+    }
+    values.push_back(std::move(current));
+    return values;
+}
+
+bool parseInteger(const std::string& text, int64_t& value) {
+    const char* begin = text.data();
+    const char* finish = text.data() + text.size();
+    auto result = std::from_chars(begin, finish, value);
+    return result.ec == std::errc() && result.ptr == finish;
+}
+
+}
@@ -1,122 +1,654 @@
 #include "../../include/services/search_service.h"
+#include "../../include/services/text_search.h"
 #include <algorithm>
+#include <iterator>
 #include <regex>
 #include <chrono>
 #include <ctime>
 #include <sstream>
 #include <iomanip>
 
-std::vector<Task> SearchService::search(
+namespace {
+
+// Условие расширенного поиска. selectivity - оценка доли подходящих задач,
+// cost - относительная цена одной проверки.
+struct Condition {
+    enum Kind { Priority, Completed, Category, Group, Due, Tag, Keyword };
+
+    Kind kind;
+    int number = 0;
+    Symbol symbol;
+    Date day;
+    double selectivity = 1.0;
+    double cost = 1.0;
+};
+
+struct Plan {
+    std::vector<Condition> conditions;
+    SearchService::PreparedQuery keyword;
+};
+
+constexpr size_t SAMPLE_SIZE = 256;
+// Следующий список индекса пересекается с кандидатами, только если он не
+// больше во столько раз; иначе дешевле проверить кандидатов по условию.
+constexpr size_t MAX_INTERSECTION_RATIO = 16;
+// Список индекса строится только для условия, которому по оценке
+// удовлетворяет не больше этой доли задач; для частых значений дешевле
+// проверить условие при просмотре.
+constexpr double MAX_INDEX_SELECTIVITY = 0.1;
+
+uint32_t categoryOf(const Task& task) { return task.getCategorySymbol().getId(); }
+uint32_t categoryOf(const TaskStore::View& task) { return task.getCategoryId(); }
+uint32_t groupOf(const Task& task) { return task.getProjectGroupSymbol().getId(); }
+uint32_t groupOf(const TaskStore::View& task) { return task.getProjectGroupId(); }
+const Task& recordOf(const Task& task) { return task; }
+const Task& recordOf(const TaskStore::View& task) { return task.task(); }
+
+template <typename Row>
+bool satisfies(const Row& row, const Condition& condition, const Plan& plan) {
+    switch (condition.kind) {
+        case Condition::Priority:
+            return row.getPriority() == condition.number;
+        case Condition::Completed:
+            return row.isCompleted() == (condition.number != 0);
+        case Condition::Category:
+            return categoryOf(row) == condition.symbol.getId();
+        case Condition::Group:
+            return groupOf(row) == condition.symbol.getId();
+        case Condition::Due:
+            return row.getDue() == condition.day;
+        case Condition::Tag:
+            return recordOf(row).hasTag(condition.symbol);
+        case Condition::Keyword:
+            return SearchService::matchesQuery(row, plan.keyword);
+    }
+    return false;
+}
+
+template <typename Row>
+bool satisfiesAll(const Row& row, const Plan& plan) {
+    for (const auto& condition : plan.conditions) {
+        if (!satisfies(row, condition, plan)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Условия из критериев с начальными оценками. false, если результат заведомо
+// пуст: значения категории, тега или группы нет ни у одной задачи.
+bool planConditions(const SearchService::SearchCriteria& criteria, Plan& plan) {
+    auto add = [&plan](Condition::Kind kind, double selectivity, double cost) -> Condition& {
+        Condition condition;
+        condition.kind = kind;
+        condition.selectivity = selectivity;
+        condition.cost = cost;
+        plan.conditions.push_back(condition);
+        return plan.conditions.back();
+    };
+    auto addSymbol = [&add](Condition::Kind kind, const std::string& text, double selectivity, double cost) {
+        auto symbol = Symbol::lookup(text);
+        if (!symbol) {
+            return false;
+        }
+        add(kind, selectivity, cost).symbol = *symbol;
+        return true;
+    };
+
+    if (criteria.completedOnly && criteria.incompleteOnly) {
+        return false;
+    }
+    if (criteria.priority != 0) {
+        add(Condition::Priority, 0.2, 1.0).number = criteria.priority;
+    }
+    if (criteria.completedOnly || criteria.incompleteOnly) {
+        add(Condition::Completed, 0.5, 1.0).number = criteria.completedOnly ? 1 : 0;
+    }
+    if (!criteria.category.empty() && !addSymbol(Condition::Category, criteria.category, 0.1, 1.0)) {
+        return false;
+    }
+    if (!criteria.projectGroup.empty() && !addSymbol(Condition::Group, criteria.projectGroup, 0.1, 1.0)) {
+        return false;
+    }
+    if (!criteria.dueDate.empty()) {
+        auto day = Date::parse(criteria.dueDate);
+        if (!day) {
+            return false;
+        }
+        add(Condition::Due, 0.01, 1.0).day = *day;
+    }
+    if (!criteria.tag.empty() && !addSymbol(Condition::Tag, criteria.tag, 0.05, 4.0)) {
+        return false;
+    }
+    if (!criteria.keyword.empty()) {
+        plan.keyword = SearchService::prepareQuery(criteria.keyword, SearchService::SearchOptions());
+        add(Condition::Keyword, 0.05, 32.0);
+    }
+    return true;
+}
+
+// Уточняет оценки по равномерной выборке строк. Ключевое слово на выборке
+// проверяется по полному объекту: сложенные копии хранилища могут быть еще
+// не построены.
+template <typename RowAt>
+void estimateSelectivity(Plan& plan, size_t count, RowAt&& rowAt) {
+    if (count == 0) {
+        return;
+    }
+
+    size_t stride = std::max<size_t>(1, count / SAMPLE_SIZE);
+    for (auto& condition : plan.conditions) {
+        size_t sampled = 0;
+        size_t matched = 0;
+        for (size_t row = 0; row < count; row += stride) {
+            sampled++;
+            bool matches = condition.kind == Condition::Keyword
+                               ? SearchService::matchesQuery(recordOf(rowAt(row)), plan.keyword)
+                               : satisfies(rowAt(row), condition, plan);
+            if (matches) {
+                matched++;
+            }
+        }
+        // Сглаживание, чтобы редкое значение не считалось невозможным.
+        condition.selectivity = (static_cast<double>(matched) + 0.5) / (static_cast<double>(sampled) + 1.0);
+    }
+}
+
+// Порядок проверки независимых условий с наименьшей ожидаемой ценой:
+// по возрастанию cost / (1 - selectivity).
+void orderConditions(Plan& plan) {
+    auto rank = [](const Condition& condition) {
+        return condition.cost / std::max(1.0 - condition.selectivity, 1e-6);
+    };
+    std::stable_sort(plan.conditions.begin(), plan.conditions.end(),
+                     [&rank](const Condition& a, const Condition& b) { return rank(a) < rank(b); });
+}
+
+// Задачи, в которых есть все слова text как целые слова. Для тега это
+// надмножество задач с этим тегом: слова тегов тоже попадают в индекс.
+std::optional<std::vector<int>> wholeWordCandidates(const SearchIndex& index, std::string_view text) {
+    std::vector<const std::vector<int>*> lists;
+    SearchIndex::forEachWord(text, [&](std::string_view word) { lists.push_back(&index.exact(word)); });
+    if (lists.empty()) {
+        return std::nullopt;
+    }
+
+    std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) { return a->size() < b->size(); });
+    std::vector<int> result = *lists.front();
+    for (size_t i = 1; i < lists.size() && !result.empty(); ++i) {
+        std::vector<int> narrowed;
+        std::set_intersection(result.begin(), result.end(), lists[i]->begin(), lists[i]->end(),
+                              std::back_inserter(narrowed));
+        result = std::move(narrowed);
+    }
+    return result;
+}
+
+}
+
+TaskSelection SearchService::search(
     const std::vector<Task>& tasks,
     const std::string& query,
     const SearchOptions& options) {
 
-    std::vector<Task> results;
-
     if (query.empty()) {
-        results = tasks;
+        TaskSelection results = TaskSelection::all(tasks);
         sortTasks(results, options.sortField, options.sortAscending);
         return results;
     }
 
-    std::vector<std::string> queryWords;
-    if (options.matchWholeWord) {
-        queryWords = splitIntoWords(query);
+    TaskSelection results(tasks);
+    PreparedQuery prepared = prepareQuery(query, options);
+    for (size_t row = 0; row < tasks.size(); ++row) {
+        if (matchesQuery(tasks[row], prepared)) {
+            results.add(row);
+        }
     }
 
-    for (const auto& task : tasks) {
-        bool matched = false;
+    sortTasks(results, options.sortField, options.sortAscending);
 
-        if (options.useRegex) {
-            try {
-                std::regex pattern(query, options.caseSensitive ? std::regex_constants::ECMAScript : std::regex_constants::icase);
-                matched = std::regex_search(task.getDescription(), pattern) ||
-                         std::regex_search(task.getCategory(), pattern) ||
-                         std::regex_search(task.getNotes(), pattern);
+    return results;
+}
 
-                for (const auto& tag : task.getTags()) {
-                    if (std::regex_search(tag, pattern)) {
-                        matched = true;
-                        break;
-                    }
+TaskSelection SearchService::search(
+    const TaskStore& store,
+    const SearchIndex& index,
+    const std::string& query,
+    const SearchOptions& options) {
+
+    TaskSelection results = findMatches(store, index, query, options);
+    sortTasks(results, options.sortField, options.sortAscending);
+    return results;
+}
+
+TaskSelection SearchService::findMatches(
+    const TaskStore& store,
+    const SearchIndex& index,
+    const std::string& query,
+    const SearchOptions& options) {
+
+    if (query.empty()) {
+        return TaskSelection::all(store.all());
+    }
+
+    PreparedQuery prepared = prepareQuery(query, options);
+    std::optional<std::vector<int>> candidates;
+    if (options.useRegex) {
+        if (!prepared.pattern) {
+            candidates = index.substringCandidates(query);
+        } else {
+            for (const auto& literal : regexLiterals(query)) {
+                auto matches = index.substringCandidates(literal);
+                if (!matches) {
+                    continue;
                 }
-            } catch (const std::regex_error&) {
-                matched = caseAwareContains(task.getDescription(), query, options.caseSensitive) ||
-                         caseAwareContains(task.getCategory(), query, options.caseSensitive) ||
-                         caseAwareContains(task.getNotes(), query, options.caseSensitive);
-
-                for (const auto& tag : task.getTags()) {
-                    if (caseAwareContains(tag, query, options.caseSensitive)) {
-                        matched = true;
-                        break;
-                    }
+                if (!candidates) {
+                    candidates = std::move(matches);
+                    continue;
                 }
+
+                std::vector<int> narrowed;
+                std::set_intersection(candidates->begin(), candidates->end(), matches->begin(), matches->end(),
+                                      std::back_inserter(narrowed));
+                *candidates = std::move(narrowed);
             }
-        } else if (options.matchWholeWord) {
-            matched = false;
-
-            auto descWords = splitIntoWords(task.getDescription());
-            auto categoryWords = splitIntoWords(task.getCategory());
-            auto notesWords = splitIntoWords(task.getNotes());
-
-            for (const auto& qword : queryWords) {
-                for (const auto& word : descWords) {
-                    if (caseAwareContains(word, qword, options.caseSensitive) && word.length() == qword.length()) {
-                        matched = true;
-                        break;
-                    }
-                }
+        }
+    } else if (options.matchWholeWord) {
+        candidates = index.wordCandidates(query);
+    } else {
+        candidates = index.substringCandidates(query);
+    }
+
+    // Проверка в порядке хранения, как при полном просмотре.
+    std::vector<int> slots;
+    if (candidates) {
+        slots.reserve(candidates->size());
+        for (int id : *candidates) {
+            int slot = store.slotOf(id);
+            if (slot != TaskStore::NO_SLOT) {
+                slots.push_back(slot);
+            }
+        }
+        std::sort(slots.begin(), slots.end());
+    } else {
+        slots.resize(store.size());
+        for (size_t slot = 0; slot < store.size(); ++slot) {
+            slots[slot] = static_cast<int>(slot);
+        }
+    }
 
-                if (matched) break;
+    if (!options.caseSensitive) {
+        store.prepareFolded();
+    }
 
-                for (const auto& word : categoryWords) {
-                    if (caseAwareContains(word, qword, options.caseSensitive) && word.length() == qword.length()) {
-                        matched = true;
-                        break;
-                    }
-                }
+    TaskSelection results(store.all());
+    for (int slot : slots) {
+        if (matchesQuery(store.view(slot), prepared)) {
+            results.add(slot);
+        }
+    }
+    return results;
+}
 
-                if (matched) break;
+SearchService::SearchPage SearchService::searchPage(
+    const TaskStore& store,
+    const SearchIndex& index,
+    const std::string& query,
+    const SearchOptions& options,
+    const PageRequest& page) {
 
-                for (const auto& word : notesWords) {
-                    if (caseAwareContains(word, qword, options.caseSensitive) && word.length() == qword.length()) {
-                        matched = true;
-                        break;
-                    }
-                }
+    SearchPage result;
+    result.tasks = findMatches(store, index, query, options);
+    result.totalMatches = result.tasks.size();
+
+    SortSpec order = sortSpecOf(options.sortField, options.sortAscending).thenById();
+    if (page.after) {
+        const Task& last = page.after->last;
+        result.tasks.keepIf([&](const Task& task) { return order.less(last, task); });
+    }
+    result.firstPosition = result.totalMatches - result.tasks.size();
 
-                if (matched) break;
+    size_t remaining = result.tasks.size();
+    size_t end = page.offset + page.limit;
+    result.tasks.partialSort(end, [&order](const Task& a, const Task& b) { return order.less(a, b); });
+    result.tasks.dropFront(page.offset);
+    result.firstPosition += std::min(page.offset, remaining);
 
-                for (const auto& tag : task.getTags()) {
-                    if (caseAwareContains(tag, qword, options.caseSensitive) && tag.length() == qword.length()) {
-                        matched = true;
-                        break;
-                    }
-                }
+    if (remaining > end && !result.tasks.empty()) {
+        result.next = PageCursor{result.tasks[result.tasks.size() - 1]};
+    }
+    return result;
+}
+
+TaskSelection SearchService::advancedSearch(const std::vector<Task>& tasks, const SearchCriteria& criteria) {
+    Plan plan;
+    if (!planConditions(criteria, plan)) {
+        return {};
+    }
+    estimateSelectivity(plan, tasks.size(), [&tasks](size_t row) -> const Task& { return tasks[row]; });
+    orderConditions(plan);
+
+    TaskSelection results(tasks);
+    for (size_t row = 0; row < tasks.size(); ++row) {
+        if (satisfiesAll(tasks[row], plan)) {
+            results.add(row);
+        }
+    }
+    return results;
+}
+
+TaskSelection SearchService::advancedSearch(const TaskStore& store, const SearchIndex& index,
+                                            const SearchCriteria& criteria) {
+    Plan plan;
+    if (!planConditions(criteria, plan) || store.empty()) {
+        return {};
+    }
+    estimateSelectivity(plan, store.size(), [&store](size_t row) { return store.view(row); });
+
+    // Доля задач, которые пропустят условия по столбцам.
+    double columnSelectivity = 1.0;
+    for (const auto& condition : plan.conditions) {
+        if (condition.kind != Condition::Tag && condition.kind != Condition::Keyword) {
+            columnSelectivity *= condition.selectivity;
+        }
+    }
+
+    // Списки индекса для редких тега и ключевого слова, если они сужают
+    // выборку сильнее столбцов. Размер списка - точная верхняя граница
+    // числа подходящих задач.
+    std::vector<std::vector<int>> lists;
+    for (auto& condition : plan.conditions) {
+        if (condition.selectivity > MAX_INDEX_SELECTIVITY || condition.selectivity > columnSelectivity) {
+            continue;
+        }
+
+        std::optional<std::vector<int>> list;
+        if (condition.kind == Condition::Tag) {
+            list = wholeWordCandidates(index, condition.symbol.str());
+        } else if (condition.kind == Condition::Keyword) {
+            list = index.substringCandidates(criteria.keyword);
+        }
+        if (!list) {
+            continue;
+        }
+
+        double bound = static_cast<double>(list->size()) / static_cast<double>(store.size());
+        condition.selectivity = std::min(condition.selectivity, bound);
+        lists.push_back(std::move(*list));
+    }
+    orderConditions(plan);
+
+    std::sort(lists.begin(), lists.end(), [](const auto& a, const auto& b) { return a.size() < b.size(); });
+    std::optional<std::vector<int>> candidates;
+    for (auto& list : lists) {
+        if (!candidates) {
+            candidates = std::move(list);
+            continue;
+        }
+        if (candidates->empty() || list.size() > candidates->size() * MAX_INTERSECTION_RATIO) {
+            break;
+        }
+
+        std::vector<int> narrowed;
+        std::set_intersection(candidates->begin(), candidates->end(), list.begin(), list.end(),
+                              std::back_inserter(narrowed));
+        *candidates = std::move(narrowed);
+    }
+
+    if (!plan.keyword.text.empty() && plan.keyword.foldsText()) {
+        store.prepareFolded();
+    }
+
+    TaskSelection results(store.all());
+    auto check = [&](size_t slot) {
+        if (satisfiesAll(store.view(slot), plan)) {
+            results.add(slot);
+        }
+    };
 
-                if (matched) break;
+    // Кандидаты из индекса проверяются в порядке хранения, как при полном просмотре.
+    if (candidates && candidates->size() < store.size() / 2) {
+        std::vector<int> slots;
+        slots.reserve(candidates->size());
+        for (int id : *candidates) {
+            int slot = store.slotOf(id);
+            if (slot != TaskStore::NO_SLOT) {
+                slots.push_back(slot);
             }
-        } else {
-            matched = caseAwareContains(task.getDescription(), query, options.caseSensitive) ||
-                     caseAwareContains(task.getCategory(), query, options.caseSensitive) ||
-                     caseAwareContains(task.getNotes(), query, options.caseSensitive);
+        }
+        std::sort(slots.begin(), slots.end());
+        for (int slot : slots) {
+            check(static_cast<size_t>(slot));
+        }
+    } else {
+        for (size_t slot = 0; slot < store.size(); ++slot) {
+            check(slot);
+        }
+    }
+    return results;
+}
 
-            for (const auto& tag : task.getTags()) {
-                if (caseAwareContains(tag, query, options.caseSensitive)) {
-                    matched = true;
-                    break;
+SearchService::PreparedQuery SearchService::prepareQuery(const std::string& query, const SearchOptions& options) {
+    PreparedQuery prepared;
+    prepared.text = query;
+    prepared.folded = CaseFolding::fold(query);
+    prepared.options = options;
+    if (options.matchWholeWord) {
+        prepared.words = splitIntoWords(options.caseSensitive ? query : prepared.folded);
+    }
+    if (options.useRegex) {
+        prepared.pattern = RegexMatcher::compile(query, options.caseSensitive);
+    }
+    return prepared;
+}
+
+bool SearchService::matchesQuery(const Task& task, const PreparedQuery& query) {
+    if (!query.foldsText()) {
+        return matchesFields(task, task.getDescription(), task.getNotes(), query);
+    }
+
+    thread_local std::string description;
+    thread_local std::string notes;
+    return matchesFields(task, CaseFolding::foldInto(task.getDescription(), description),
+                         CaseFolding::foldInto(task.getNotes(), notes), query);
+}
+
+bool SearchService::matchesQuery(const TaskStore::View& task, const PreparedQuery& query) {
+    if (!query.foldsText()) {
+        return matchesFields(task.task(), task.getDescription(), task.getNotes(), query);
+    }
+    return matchesFields(task.task(), task.getFoldedDescription(), task.getFoldedNotes(), query);
+}
+
+bool SearchService::matchesFields(const Task& task, std::string_view description, std::string_view notes,
+                                  const PreparedQuery& query) {
+    const bool folded = query.foldsText();
+    std::string_view category = folded ? task.getCategorySymbol().folded() : task.getCategory();
+
+    if (query.options.useRegex && query.pattern) {
+        RegexMatcher& pattern = *query.pattern;
+        auto search = [&](std::string_view text) {
+            return folded ? pattern.searchFolded(text) : pattern.search(text);
+        };
+        if (search(description) || search(category) || search(notes)) {
+            return true;
+        }
+
+        for (Symbol tag : task.getTagSymbols()) {
+            if (search(folded ? tag.folded() : tag.str())) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    if (query.options.matchWholeWord && !query.options.useRegex) {
+        for (const auto& word : query.words) {
+            if (containsWord(description, word) || containsWord(category, word) || containsWord(notes, word)) {
+                return true;
+            }
+
+            for (Symbol tag : task.getTagSymbols()) {
+                if ((folded ? tag.folded() : tag.str()) == word) {
+                    return true;
                 }
             }
         }
+        return false;
+    }
 
-        if (matched) {
-            results.push_back(task);
+    // Подстрока, а также некорректное регулярное выражение.
+    std::string_view needle = folded ? query.folded : query.text;
+    if (TextSearch::contains(description, needle) ||
+        TextSearch::contains(category, needle) ||
+        TextSearch::contains(notes, needle)) {
+        return true;
+    }
+
+    for (Symbol tag : task.getTagSymbols()) {
+        std::string_view text = folded ? tag.folded() : tag.str();
+        if (TextSearch::contains(text, needle)) {
+            return true;
         }
     }
+    return false;
+}
 
-    sortTasks(results, options.sortField, options.sortAscending);
+bool SearchService::containsWord(std::string_view text, std::string_view word) {
+    if (word.empty()) {
+        return false;
+    }
 
-    return results;
+    for (size_t pos = TextSearch::find(text, word); pos != TextSearch::npos;
+         pos = TextSearch::find(text, word, pos + 1)) {
+        size_t end = pos + word.size();
+        bool startsWord = pos == 0 || !SearchIndex::isWordByte(static_cast<unsigned char>(text[pos - 1]));
+        bool endsWord = end == text.size() || !SearchIndex::isWordByte(static_cast<unsigned char>(text[end]));
+        if (startsWord && endsWord) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<std::string> SearchService::regexLiterals(const std::string& pattern) {
+    std::vector<std::string> literals;
+    std::string current;
+    auto flush = [&]() {
+        if (!current.empty()) {
+            literals.push_back(std::move(current));
+            current.clear();
+        }
+    };
+
+    // Пропускает [...] или (...), начиная с открывающей скобки; возвращает позицию после закрывающей.
+    auto skipClass = [&](size_t pos) {
+        pos++;
+        if (pos < pattern.size() && pattern[pos] == '^') {
+            pos++;
+        }
+        if (pos < pattern.size() && pattern[pos] == ']') {
+            pos++;
+        }
+        while (pos < pattern.size() && pattern[pos] != ']') {
+            pos += pattern[pos] == '\\' ? 2 : 1;
+        }
+        return pos + 1;
+    };
+    auto skipGroup = [&](size_t pos) {
+        int depth = 0;
+        while (pos < pattern.size()) {
+            char c = pattern[pos];
+            if (c == '\\') {
+                pos += 2;
+                continue;
+            }
+            if (c == '[') {
+                pos = skipClass(pos);
+                continue;
+            }
+            if (c == '(') {
+                depth++;
+            } else if (c == ')' && --depth == 0) {
+                return pos + 1;
+            }
+            pos++;
+        }
+        return pos;
+    };
+
+    size_t i = 0;
+    while (i < pattern.size()) {
+        char c = pattern[i];
+        switch (c) {
+            case '\\': {
+                if (i + 1 >= pattern.size()) {
+                    i++;
+                    break;
+                }
+                char escaped = pattern[i + 1];
+                if (std::isalnum(static_cast<unsigned char>(escaped))) {
+                    // \d, \w, \b и т.п. - не литерал; у \x, \u и \c есть аргумент.
+                    flush();
+                    i += 2;
+                    if (escaped == 'x') {
+                        i += 2;
+                    } else if (escaped == 'u') {
+                        i += 4;
+                    } else if (escaped == 'c') {
+                        i += 1;
+                    }
+                } else {
+                    current += escaped;
+                    i += 2;
+                }
+                break;
+            }
+            case '[':
+                flush();
+                i = skipClass(i);
+                break;
+            case '(':
+                flush();
+                i = skipGroup(i);
+                break;
+            case '|':
+            case ')':
+                return {};
+            case '.':
+            case '^':
+            case '$':
+                flush();
+                i++;
+                break;
+            case '*':
+            case '?':
+            case '+':
+            case '{': {
+                // Квантификатор относится к последнему символу: при нуле повторений его может не быть.
+                bool optional = c != '+';
+                if (c == '{') {
+                    size_t end = pattern.find('}', i);
+                    optional = i + 1 < pattern.size() && pattern[i + 1] == '0';
+                    i = end == std::string::npos ? pattern.size() : end;
+                }
+                if (optional && !current.empty()) {
+                    current.pop_back();
+                }
+                flush();
+                i++;
+                if (i < pattern.size() && pattern[i] == '?') {
+                    i++;
+                }
+                break;
+            }
+            default:
+                current += c;
+                i++;
+        }
+    }
+    flush();
+    return literals;
 }
 
 std::vector<std::string> SearchService::splitIntoWords(const std::string& text) {
@@ -124,7 +656,7 @@ std::vector<std::string> SearchService::splitIntoWords(const std::string& text)
     std::string word;
 
     for (char c : text) {
-        if (std::isalnum(c) || c == '_') {
+        if (SearchIndex::isWordByte(static_cast<unsigned char>(c))) {
             word += c;
         } else if (!word.empty()) {
             words.push_back(word);
@@ -145,35 +677,28 @@ bool SearchService::caseAwareContains(const std::string& haystack, const std::st
     }
 
     if (caseSensitive) {
-        return haystack.find(needle) != std::string::npos;
-    } else {
-        std::string haystackLower = toLowerCase(haystack);
-        std::string needleLower = toLowerCase(needle);
-        return haystackLower.find(needleLower) != std::string::npos;
+        return TextSearch::contains(haystack, needle);
     }
+
+    thread_local std::string haystackFolded;
+    thread_local std::string needleFolded;
+    return TextSearch::contains(CaseFolding::foldInto(haystack, haystackFolded),
+                                CaseFolding::foldInto(needle, needleFolded));
 }
 
 std::string SearchService::toLowerCase(const std::string& text) {
-    std::string result = text;
-    std::transform(result.begin(), result.end(), result.begin(),
-                   [](unsigned char c) { return std::tolower(c); });
-    return result;
+    return CaseFolding::fold(text);
 }
 
 void SearchService::sortTasks(std::vector<Task>& tasks, const std::string& field, bool ascending) {
-    auto comparator = [&field, ascending](const Task& a, const Task& b) {
-        if (field == "dueDate") {
-            return ascending ? (a.getDueDate() < b.getDueDate()) : (a.getDueDate() > b.getDueDate());
-        } else if (field == "priority") {
-            return ascending ? (a.getPriority() < b.getPriority()) : (a.getPriority() > b.getPriority());
-        } else if (field == "category") {
-            return ascending ? (a.getCategory() < b.getCategory()) : (a.getCategory() > b.getCategory());
-        } else if (field == "description") {
-            return ascending ? (a.getDescription() < b.getDescription()) : (a.getDescription() > b.getDescription());
-        } else {
-            return ascending ? (a.getId() < b.getId()) : (a.getId() > b.getId());
-        }
-    };
+    sortSpecOf(field, ascending).sort(tasks);
+}
+
+void SearchService::sortTasks(TaskSelection& tasks, const std::string& field, bool ascending) {
+    sortSpecOf(field, ascending).sort(tasks);
+}
 
-    std::sort(tasks.begin(), tasks.end(), comparator);
+SortSpec SearchService::sortSpecOf(const std::string& field, bool ascending) {
+    auto spec = SortSpec::parse(field, ascending);
+    return spec ? *spec : SortSpec({{SortSpec::Field::Id, ascending}});
 }
\ No newline at end of file
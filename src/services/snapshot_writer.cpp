@@ -0,0 +1,81 @@
+#include "../../include/services/snapshot_writer.h"
+#include "../../include/services/logger.h"
+
+SnapshotWriter::SnapshotWriter()
+    : durableSequence(0), busy(false), stopping(false) {
+    worker = std::thread(&SnapshotWriter::run, this);
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void SnapshotWriter::submit(int64_t sequence, Job job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending = PendingJob{sequence, std::move(job)};
+    }
+    workAvailable.notify_one();
+}
+
+void SnapshotWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    workFinished.wait(lock, [this] { return !pending && !busy; });
+}
+
+void SnapshotWriter::setDurableCallback(DurableCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+    onDurable = std::move(callback);
+}
+
+int64_t SnapshotWriter::getDurableSequence() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return durableSequence;
+}
+
+void SnapshotWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        workAvailable.wait(lock, [this] { return pending || stopping; });
+        if (!pending) {
+            break;
+        }
+
+        PendingJob current = std::move(*pending);
+        pending.reset();
+        busy = true;
+        lock.unlock();
+
+        bool success = false;
+        try {
+            success = current.job();
+        } catch (const std::exception& e) {
+            Logger::getInstance().error("Ошибка фоновой записи снимка: " + std::string(e.what()));
+        }
+
+        DurableCallback callback;
+        lock.lock();
+        if (success && current.sequence > durableSequence) {
+            durableSequence = current.sequence;
+            callback = onDurable;
+        }
+
+        if (callback) {
+            lock.unlock();
+            callback(current.sequence);
+            lock.lock();
+        }
+
+        busy = false;
+        workFinished.notify_all();
+    }
+}
@@ -0,0 +1,485 @@
+#include "../../include/services/task_query.h"
+#include <algorithm>
+#include <charconv>
+
+namespace {
+
+constexpr int MAX_NESTING = 64;
+
+uint32_t categoryOf(const Task& task) { return task.getCategorySymbol().getId(); }
+uint32_t categoryOf(const TaskStore::View& task) { return task.getCategoryId(); }
+uint32_t groupOf(const Task& task) { return task.getProjectGroupSymbol().getId(); }
+uint32_t groupOf(const TaskStore::View& task) { return task.getProjectGroupId(); }
+const Task& recordOf(const Task& task) { return task; }
+const Task& recordOf(const TaskStore::View& task) { return task.task(); }
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool isIdentifierChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+bool isDelimiter(char c) {
+    return isSpace(c) || c == '(' || c == ')' || c == '|' || c == '&' || c == '"';
+}
+
+std::string lowerAscii(std::string_view text) {
+    std::string result(text);
+    for (auto& c : result) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return result;
+}
+
+}
+
+class TaskQuery::Parser {
+private:
+    std::string_view text;
+    size_t pos = 0;
+    int depth = 0;
+    TaskQuery& query;
+    std::string error;
+
+    void skipSpaces() {
+        while (pos < text.size() && isSpace(text[pos])) {
+            pos++;
+        }
+    }
+
+    bool atEnd() {
+        skipSpaces();
+        return pos >= text.size();
+    }
+
+    // Ключевое слово целиком, без учета регистра.
+    bool acceptKeyword(std::string_view keyword) {
+        skipSpaces();
+        if (text.size() - pos < keyword.size() || lowerAscii(text.substr(pos, keyword.size())) != keyword) {
+            return false;
+        }
+        size_t end = pos + keyword.size();
+        if (end < text.size() && !isDelimiter(text[end])) {
+            return false;
+        }
+        pos = end;
+        return true;
+    }
+
+    bool acceptChar(char c) {
+        skipSpaces();
+        if (pos < text.size() && text[pos] == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    bool fail(std::string message) {
+        if (error.empty()) {
+            error = std::move(message);
+        }
+        return false;
+    }
+
+    size_t emit(Op op, Compare compare = Compare::Equal, int32_t value = 0) {
+        query.program.push_back(Instruction{op, compare, value});
+        return query.program.size() - 1;
+    }
+
+    void patch(const std::vector<size_t>& jumps) {
+        for (size_t jump : jumps) {
+            query.program[jump].value = static_cast<int32_t>(query.program.size());
+        }
+    }
+
+    bool parseOr() {
+        if (!parseAnd()) {
+            return false;
+        }
+
+        std::vector<size_t> exits;
+        while (acceptChar('|') || acceptKeyword("or")) {
+            exits.push_back(emit(Op::JumpIfTrue));
+            if (!parseAnd()) {
+                return false;
+            }
+        }
+        patch(exits);
+        return true;
+    }
+
+    bool startsOperand() {
+        if (atEnd() || text[pos] == ')' || text[pos] == '|') {
+            return false;
+        }
+        size_t saved = pos;
+        bool isOr = acceptKeyword("or");
+        pos = saved;
+        return !isOr;
+    }
+
+    bool parseAnd() {
+        if (!parseUnary()) {
+            return false;
+        }
+
+        std::vector<size_t> exits;
+        while (true) {
+            bool explicitAnd = acceptChar('&') || acceptKeyword("and");
+            if (!startsOperand()) {
+                if (explicitAnd) {
+                    return fail("Ожидалось условие после 'and'");
+                }
+                break;
+            }
+            exits.push_back(emit(Op::JumpIfFalse));
+            if (!parseUnary()) {
+                return false;
+            }
+        }
+        patch(exits);
+        return true;
+    }
+
+    // Отрицания считаются в цикле, а не рекурсией: длинная цепочка "!!!..."
+    // не должна переполнять стек. Четное число отрицаний взаимно уничтожается.
+    bool parseUnary() {
+        size_t negations = 0;
+        while (true) {
+            if (atEnd()) {
+                return fail("Ожидалось условие");
+            }
+            if (text[pos] == '!' || (text[pos] == '-' && pos + 1 < text.size() && !isSpace(text[pos + 1]))) {
+                pos++;
+                negations++;
+            } else if (acceptKeyword("not")) {
+                negations++;
+            } else {
+                break;
+            }
+        }
+
+        if (!parsePrimary()) {
+            return false;
+        }
+        if (negations % 2 == 1) {
+            emit(Op::Not);
+        }
+        return true;
+    }
+
+    bool parsePrimary() {
+        if (acceptChar('(')) {
+            if (++depth > MAX_NESTING) {
+                return fail("Слишком глубокая вложенность скобок");
+            }
+            if (!parseOr()) {
+                return false;
+            }
+            if (!acceptChar(')')) {
+                return fail("Не закрыта скобка");
+            }
+            depth--;
+            return true;
+        }
+        if (text[pos] == ')') {
+            return fail("Лишняя ')'");
+        }
+        size_t saved = pos;
+        if (acceptKeyword("and") || acceptKeyword("or")) {
+            pos = saved;
+            return fail("Ожидалось условие");
+        }
+        return parseTerm();
+    }
+
+    bool readValue(std::string& value) {
+        if (pos < text.size() && text[pos] == '"') {
+            return readQuoted(value);
+        }
+        size_t start = pos;
+        while (pos < text.size() && !isDelimiter(text[pos])) {
+            pos++;
+        }
+        value.assign(text.substr(start, pos - start));
+        return true;
+    }
+
+    bool readQuoted(std::string& value) {
+        pos++;
+        value.clear();
+        while (pos < text.size() && text[pos] != '"') {
+            if (text[pos] == '\\' && pos + 1 < text.size()) {
+                pos++;
+            }
+            value += text[pos++];
+        }
+        if (pos >= text.size()) {
+            return fail("Не закрыта кавычка");
+        }
+        pos++;
+        return true;
+    }
+
+    bool readCompare(Compare& compare) {
+        static constexpr std::pair<std::string_view, Compare> operators[] = {
+            {"!=", Compare::NotEqual}, {"<=", Compare::LessEqual}, {">=", Compare::GreaterEqual},
+            {"<", Compare::Less},      {">", Compare::Greater},    {"=", Compare::Equal},
+            {":", Compare::Equal},
+        };
+        for (const auto& [token, value] : operators) {
+            if (text.substr(pos, token.size()) == token) {
+                pos += token.size();
+                compare = value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool parseTerm() {
+        if (text[pos] == '"') {
+            std::string value;
+            return readQuoted(value) && addText(value);
+        }
+
+        size_t start = pos;
+        while (pos < text.size() && isIdentifierChar(text[pos])) {
+            pos++;
+        }
+        std::string field = lowerAscii(text.substr(start, pos - start));
+
+        Compare compare;
+        size_t afterField = pos;
+        skipSpaces();
+        if (!field.empty() && readCompare(compare)) {
+            skipSpaces();
+            std::string value;
+            if (!readValue(value)) {
+                return false;
+            }
+            if (value.empty()) {
+                return fail("Ожидалось значение после '" + field + "'");
+            }
+            return addField(field, compare, value);
+        }
+
+        pos = afterField;
+        if (field == "done" && (pos >= text.size() || isDelimiter(text[pos]))) {
+            emit(Op::Completed);
+            return true;
+        }
+
+        // Слово без поля - поиск текста.
+        pos = start;
+        std::string value;
+        readValue(value);
+        if (value.empty()) {
+            return fail("Неожиданный символ '" + std::string(1, text[pos]) + "'");
+        }
+        return addText(value);
+    }
+
+    bool addText(const std::string& value) {
+        if (value.empty()) {
+            return fail("Пустая строка поиска");
+        }
+        query.texts.push_back(SearchService::prepareQuery(value, SearchService::SearchOptions()));
+        emit(Op::Text, Compare::Equal, static_cast<int32_t>(query.texts.size() - 1));
+        return true;
+    }
+
+    bool addSymbol(Op op, const std::string& field, Compare compare, const std::string& value) {
+        if (compare != Compare::Equal && compare != Compare::NotEqual) {
+            return fail("Поле '" + field + "' поддерживает только : = !=");
+        }
+        auto symbol = Symbol::lookup(value);
+        if (symbol) {
+            emit(op, Compare::Equal, static_cast<int32_t>(symbol->getId()));
+        } else {
+            emit(Op::Constant, Compare::Equal, 0);
+        }
+        if (compare == Compare::NotEqual) {
+            emit(Op::Not);
+        }
+        return true;
+    }
+
+    bool addNumber(Op op, const std::string& field, Compare compare, const std::string& value) {
+        int32_t number = 0;
+        auto [end, code] = std::from_chars(value.data(), value.data() + value.size(), number);
+        if (code != std::errc() || end != value.data() + value.size()) {
+            return fail("Некорректное число для '" + field + "': " + value);
+        }
+        emit(op, compare, number);
+        return true;
+    }
+
+    bool addField(const std::string& field, Compare compare, const std::string& value) {
+        if (field == "tag") {
+            return addSymbol(Op::Tag, field, compare, value);
+        }
+        if (field == "cat" || field == "category") {
+            return addSymbol(Op::Category, field, compare, value);
+        }
+        if (field == "group") {
+            return addSymbol(Op::Group, field, compare, value);
+        }
+        if (field == "prio" || field == "priority") {
+            return addNumber(Op::Priority, field, compare, value);
+        }
+        if (field == "id") {
+            return addNumber(Op::Id, field, compare, value);
+        }
+        if (field == "text") {
+            if (compare != Compare::Equal) {
+                return fail("Поле 'text' поддерживает только ':'");
+            }
+            return addText(value);
+        }
+        if (field == "due") {
+            std::string lowered = lowerAscii(value);
+            Date day;
+            if (lowered == "today") {
+                day = Date::today();
+            } else if (lowered == "none") {
+                if (compare != Compare::Equal && compare != Compare::NotEqual) {
+                    return fail("'due:none' поддерживает только : = !=");
+                }
+            } else if (auto parsed = Date::parse(value)) {
+                day = *parsed;
+            } else {
+                return fail("Некорректная дата: " + value);
+            }
+            emit(Op::Due, compare, day.days());
+            return true;
+        }
+        if (field == "done") {
+            std::string lowered = lowerAscii(value);
+            bool yes = lowered == "yes" || lowered == "true" || lowered == "1";
+            bool no = lowered == "no" || lowered == "false" || lowered == "0";
+            if ((!yes && !no) || (compare != Compare::Equal && compare != Compare::NotEqual)) {
+                return fail("Ожидалось done:yes или done:no");
+            }
+            emit(Op::Completed);
+            if (no != (compare == Compare::NotEqual)) {
+                emit(Op::Not);
+            }
+            return true;
+        }
+        return fail("Неизвестное поле: " + field);
+    }
+
+public:
+    Parser(std::string_view text, TaskQuery& query) : text(text), query(query) {}
+
+    bool parse() {
+        if (atEnd()) {
+            return true;
+        }
+        if (!parseOr()) {
+            return false;
+        }
+        if (!atEnd()) {
+            return fail(text[pos] == ')' ? "Лишняя ')'" : "Неожиданный символ '" + std::string(1, text[pos]) + "'");
+        }
+        return true;
+    }
+
+    const std::string& getError() const { return error; }
+};
+
+std::optional<TaskQuery> TaskQuery::compile(std::string_view text, std::string* error) {
+    TaskQuery query;
+    Parser parser(text, query);
+    if (!parser.parse()) {
+        if (error) {
+            *error = parser.getError();
+        }
+        return std::nullopt;
+    }
+    return query;
+}
+
+template <typename Row>
+bool TaskQuery::run(const Row& task) const {
+    bool result = true;
+    const size_t size = program.size();
+    for (size_t pc = 0; pc < size;) {
+        const Instruction& instruction = program[pc++];
+        switch (instruction.op) {
+            case Op::Priority:
+                result = compare(task.getPriority(), instruction.compare, instruction.value);
+                break;
+            case Op::Id:
+                result = compare(task.getId(), instruction.compare, instruction.value);
+                break;
+            case Op::Due: {
+                int32_t due = task.getDue().days();
+                // Задача без срока не раньше и не позже никакой даты.
+                bool ordered = instruction.compare != Compare::Equal && instruction.compare != Compare::NotEqual;
+                if (ordered && (due == Date::NONE || instruction.value == Date::NONE)) {
+                    result = false;
+                } else {
+                    result = compare(due, instruction.compare, instruction.value);
+                }
+                break;
+            }
+            case Op::Completed:
+                result = task.isCompleted();
+                break;
+            case Op::Category:
+                result = categoryOf(task) == static_cast<uint32_t>(instruction.value);
+                break;
+            case Op::Group:
+                result = groupOf(task) == static_cast<uint32_t>(instruction.value);
+                break;
+            case Op::Tag: {
+                const auto& tags = recordOf(task).getTagSymbols();
+                uint32_t tag = static_cast<uint32_t>(instruction.value);
+                result = std::any_of(tags.begin(), tags.end(), [tag](Symbol symbol) { return symbol.getId() == tag; });
+                break;
+            }
+            case Op::Text:
+                result = SearchService::matchesQuery(task, texts[instruction.value]);
+                break;
+            case Op::Constant:
+                result = instruction.value != 0;
+                break;
+            case Op::Not:
+                result = !result;
+                break;
+            case Op::JumpIfFalse:
+                if (!result) {
+                    pc = static_cast<size_t>(instruction.value);
+                }
+                break;
+            case Op::JumpIfTrue:
+                if (result) {
+                    pc = static_cast<size_t>(instruction.value);
+                }
+                break;
+        }
+    }
+    return result;
+}
+
+bool TaskQuery::matches(const Task& task) const {
+    return run(task);
+}
+
+bool TaskQuery::matches(const TaskStore::View& task) const {
+    return run(task);
+}
+
+TaskSelection TaskQuery::select(const TaskStore& store) const {
+    if (usesText()) {
+        store.prepareFolded();
+    }
+    return store.select([this](const TaskStore::View& task) { return run(task); });
+}
@@ -0,0 +1,165 @@
+#include "../../include/services/text_search.h"
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define TEXT_SEARCH_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using FindFunction = size_t (*)(const char*, size_t, const char*, size_t);
+
+size_t findScalar(const char* haystack, size_t size, const char* needle, size_t length) {
+    return std::string_view(haystack, size).find(std::string_view(needle, length));
+}
+
+#ifdef TEXT_SEARCH_X86
+
+// Образец не короче двух байтов. Бит i маски - позиция, где совпали первый и
+// последний байты образца; середина проверяется memcmp.
+__attribute__((target("sse2")))
+inline unsigned candidatesSse2(const char* at, __m128i first, __m128i last, size_t length) {
+    __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(at));
+    __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(at + length - 1));
+    return static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast))));
+}
+
+inline size_t verify(const char* at, unsigned mask, const char* needle, size_t length) {
+    while (mask != 0) {
+        unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+        if (std::memcmp(at + bit + 1, needle + 1, length - 2) == 0) {
+            return bit;
+        }
+        mask &= mask - 1;
+    }
+    return TextSearch::npos;
+}
+
+// Последний неполный блок проверяется блоком, сдвинутым назад до конца текста,
+// с маской без уже проверенных позиций; текст короче блока ищется обычным способом.
+__attribute__((target("sse2")))
+size_t findSse2(const char* haystack, size_t size, const char* needle, size_t length) {
+    const size_t positions = size - length + 1;
+    if (positions < 16) {
+        return findScalar(haystack, size, needle, length);
+    }
+
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[length - 1]);
+
+    size_t i = 0;
+    for (; i + 16 <= positions; i += 16) {
+        size_t found = verify(haystack + i, candidatesSse2(haystack + i, first, last, length), needle, length);
+        if (found != TextSearch::npos) {
+            return i + found;
+        }
+    }
+
+    if (i < positions) {
+        size_t start = positions - 16;
+        unsigned mask = candidatesSse2(haystack + start, first, last, length) & (~0u << (i - start));
+        size_t found = verify(haystack + start, mask, needle, length);
+        if (found != TextSearch::npos) {
+            return start + found;
+        }
+    }
+    return TextSearch::npos;
+}
+
+__attribute__((target("avx2")))
+inline unsigned candidatesAvx2(const char* at, __m256i first, __m256i last, size_t length) {
+    __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(at));
+    __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(at + length - 1));
+    return static_cast<unsigned>(_mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(first, blockFirst), _mm256_cmpeq_epi8(last, blockLast))));
+}
+
+__attribute__((target("avx2")))
+size_t findAvx2(const char* haystack, size_t size, const char* needle, size_t length) {
+    const size_t positions = size - length + 1;
+    if (positions < 32) {
+        return findSse2(haystack, size, needle, length);
+    }
+
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[length - 1]);
+
+    size_t i = 0;
+    for (; i + 32 <= positions; i += 32) {
+        size_t found = verify(haystack + i, candidatesAvx2(haystack + i, first, last, length), needle, length);
+        if (found != TextSearch::npos) {
+            return i + found;
+        }
+    }
+
+    if (i < positions) {
+        size_t start = positions - 32;
+        unsigned mask = candidatesAvx2(haystack + start, first, last, length) & (~0u << (i - start));
+        size_t found = verify(haystack + start, mask, needle, length);
+        if (found != TextSearch::npos) {
+            return start + found;
+        }
+    }
+    return TextSearch::npos;
+}
+
+#endif
+
+FindFunction selectImplementation() {
+#ifdef TEXT_SEARCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return findAvx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return findSse2;
+    }
+#endif
+    return findScalar;
+}
+
+FindFunction selectedFind() {
+    static const FindFunction selected = selectImplementation();
+    return selected;
+}
+
+}
+
+size_t TextSearch::find(std::string_view haystack, std::string_view needle, size_t from) {
+    if (from > haystack.size()) {
+        return npos;
+    }
+    if (needle.empty()) {
+        return from;
+    }
+
+    const char* text = haystack.data() + from;
+    const size_t size = haystack.size() - from;
+    if (needle.size() > size) {
+        return npos;
+    }
+
+    size_t found;
+    if (needle.size() == 1) {
+        const void* hit = std::memchr(text, needle[0], size);
+        found = hit ? static_cast<size_t>(static_cast<const char*>(hit) - text) : npos;
+    } else {
+        found = selectedFind()(text, size, needle.data(), needle.size());
+    }
+    return found == npos ? npos : from + found;
+}
+
+const char* TextSearch::implementation() {
+    FindFunction selected = selectedFind();
+#ifdef TEXT_SEARCH_X86
+    if (selected == findAvx2) {
+        return "avx2";
+    }
+    if (selected == findSse2) {
+        return "sse2";
+    }
+#endif
+    return selected == findScalar ? "scalar" : "unknown";
+}
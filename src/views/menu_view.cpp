@@ -58,6 +58,9 @@ void MenuView::displayFilterSortMenu() {
     std::cout << "7. Сортировка по приоритету\n";
     std::cout << "8. Сортировка по дате\n";
     std::cout << "9. Сортировка по категории\n";
+    std::cout << "10. Расширенный поиск\n";
+    std::cout << "11. Фильтр по запросу\n";
+    std::cout << "12. Сортировка по нескольким полям\n";
     std::cout << "0. Назад\n";
     std::cout << "Ваш выбор: ";
 }
@@ -70,6 +73,7 @@ void MenuView::displayExportMenu() {
     std::cout << "4. Экспорт в HTML\n";
     std::cout << "5. Экспорт шаблонов\n";
     std::cout << "6. Импорт шаблонов\n";
+    std::cout << "7. Экспорт в tasks.json\n";
     std::cout << "0. Назад\n";
     std::cout << "Ваш выбор: ";
 }
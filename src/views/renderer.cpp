@@ -1,4 +1,5 @@
 #include "../../include/views/renderer.h"
+#include "../../include/services/clock.h"
 #include <iomanip>
 #include <sstream>
 
@@ -17,13 +18,7 @@ std::string Renderer::colorByPriority(int priority) {
 }
 
 std::string Renderer::formatTime(const std::chrono::system_clock::time_point& time) {
-    auto timeT = std::chrono::system_clock::to_time_t(time);
-    std::tm* tm = std::localtime(&timeT);
-    
-    std::ostringstream oss;
-    oss << std::put_time(tm, "%Y-%m-%d %H:%M");
-    
-    return oss.str();
+    return Clock::formatMinute(time);
 }
 
 std::string Renderer::formatStatus(bool completed) {
@@ -94,16 +89,12 @@ std::string Renderer::formatDate(const std::string& date) {
     int month = std::stoi(date.substr(5, 2));
     int day = std::stoi(date.substr(8, 2));
 
-    std::time_t now = std::time(nullptr);
-    std::tm* now_tm = std::localtime(&now);
-
-    char today[11];
-    std::strftime(today, sizeof(today), "%Y-%m-%d", now_tm);
+    std::string_view today(Clock::localMinute(Clock::now()).text, 10);
 
     std::string statusSuffix = "";
-    if (date < std::string(today)) {
+    if (std::string_view(date) < today) {
         statusSuffix = " (просрочено)";
-    } else if (date == std::string(today)) {
+    } else if (std::string_view(date) == today) {
         statusSuffix = " (сегодня)";
     }
 
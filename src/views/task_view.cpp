@@ -28,12 +28,30 @@ void TaskView::displayTask(const Task& task) {
 }
 
 void TaskView::displayTaskList(const std::vector<Task>& tasks) {
+    displayTaskList(TaskSelection::all(tasks));
+}
+
+void TaskView::displayTaskList(const TaskSelection& tasks) {
     if (tasks.empty()) {
         std::cout << WARNING_COLOR << "Список задач пуст." << RESET_COLOR << std::endl;
         return;
     }
     
     std::cout << "Список задач (" << tasks.size() << "):" << std::endl;
+    displayTaskTable(tasks);
+}
+
+void TaskView::displayTaskPage(const TaskSelection& page, size_t first, size_t total) {
+    if (page.empty()) {
+        std::cout << WARNING_COLOR << "Список задач пуст." << RESET_COLOR << std::endl;
+        return;
+    }
+
+    std::cout << "Список задач (" << first + 1 << "-" << first + page.size() << " из " << total << "):" << std::endl;
+    displayTaskTable(page);
+}
+
+void TaskView::displayTaskTable(const TaskSelection& tasks) {
     std::cout << std::setw(5) << "ID" << " | " 
               << std::setw(40) << "Описание" << " | "
               << std::setw(10) << "Срок" << " | "
@@ -55,7 +73,7 @@ void TaskView::displayTaskList(const std::vector<Task>& tasks) {
     }
 }
 
-void TaskView::displayTaskDetails(const Task& task) {
+void TaskView::displayTaskDetails(const Task& task, const TaskStore& store) {
     std::string priorityColor = Renderer::colorByPriority(task.getPriority());
     std::string statusColor = task.isCompleted() ? SUCCESS_COLOR : (task.isOverdue() ? ERROR_COLOR : WARNING_COLOR);
     
@@ -63,6 +81,10 @@ void TaskView::displayTaskDetails(const Task& task) {
     std::cout << priorityColor << "Задача #" << task.getId() << ": " << task.getDescription() << RESET_COLOR << std::endl;
     std::cout << std::string(50, '-') << std::endl;
     
+    if (task.isSubtask()) {
+        std::cout << "Подзадача задачи #" << task.getParentId() << std::endl;
+    }
+    
     std::cout << "Срок: " << Renderer::formatDate(task.getDueDate())
               << " (" << (task.isOverdue() ? ERROR_COLOR + "просрочена" :
                         (task.isDueToday() ? WARNING_COLOR + "сегодня" : "осталось дней")) << RESET_COLOR << ")" << std::endl;
@@ -91,30 +113,35 @@ void TaskView::displayTaskDetails(const Task& task) {
         std::cout << task.getNotes() << std::endl;
     }
 
-    const auto& subtasks = task.getSubtasks();
-    if (!subtasks.empty()) {
-        std::cout << std::endl << "Подзадачи (" << subtasks.size() << "):" << std::endl;
+    int slot = store.slotOf(task.getId());
+    size_t subtaskCount = 0;
+    if (slot != TaskStore::NO_SLOT) {
+        store.forEachDescendant(slot, [&](const Task&, int) { subtaskCount++; });
+    }
+    if (subtaskCount > 0) {
+        std::cout << std::endl << "Подзадачи (" << subtaskCount << "):" << std::endl;
         std::cout << std::string(30, '-') << std::endl;
         
-        for (const auto& subtask : subtasks) {
+        store.forEachDescendant(slot, [&](const Task& subtask, int depth) {
+            std::string indent(static_cast<size_t>(depth - 1) * 4, ' ');
             std::string subtaskStatusColor = subtask.isCompleted() ? SUCCESS_COLOR : (subtask.isOverdue() ? ERROR_COLOR : WARNING_COLOR);
             std::string subtaskStatus = subtask.isCompleted() ? "✓" : "⏳";
             
-            std::cout << subtaskStatusColor << subtaskStatus << RESET_COLOR << " "
+            std::cout << indent << subtaskStatusColor << subtaskStatus << RESET_COLOR << " "
                      << "#" << subtask.getId() << ": " << subtask.getDescription() << std::endl;
-            std::cout << "    Срок: " << subtask.getDueDate() 
+            std::cout << indent << "    Срок: " << subtask.getDueDate() 
                      << " | Приоритет: " << subtask.getPriority() << std::endl;
                      
             if (!subtask.getNotes().empty()) {
-                std::cout << "    Заметки: " << subtask.getNotes() << std::endl;
+                std::cout << indent << "    Заметки: " << subtask.getNotes() << std::endl;
             }
             
             if (!subtask.getTags().empty()) {
-                std::cout << "    Теги: " << Renderer::formatTags(subtask.getTags()) << std::endl;
+                std::cout << indent << "    Теги: " << Renderer::formatTags(subtask.getTags()) << std::endl;
             }
             
             std::cout << std::endl;
-        }
+        });
     }
     
     std::cout << "Создана: " << task.getCreatedDate() << std::endl;